@@ -2,11 +2,20 @@
 #include <random>
 #include <limits>
 #include <chrono>
+#include <fstream>
 #include "neural_network.h"
 #include "nn_dense.h"
 #include "nn_activation.h"
 #include "nn_loss.h"
 #include "nn_optimizer.h"
+#include "nn_sparse.h"
+#include "nn_sweep.h"
+#include "nn_metrics.h"
+#include "nn_graph.h"
+#if defined(__unix__)
+#include "nn_distributed.h"
+#include "nn_lookup.h"
+#endif
 
 using namespace utec::neural_network;
 using namespace std::chrono;
@@ -40,11 +49,15 @@ int MainMenu() {
         std::cout << "\n=== MENU PRINCIPAL ===\n";
         std::cout << "1. Entrenar y probar con valores por defecto\n";
         std::cout << "2. Entrenar y probar con parametros personalizados\n";
-        std::cout << "3. Salir\n";
+        std::cout << "3. Benchmark: capa densa vs dispersa (poda)\n";
+        std::cout << "4. Entrenamiento data-parallel multiproceso\n";
+        std::cout << "5. Barrido de hiperparametros (multi-modelo)\n";
+        std::cout << "6. Modelo en grafo multi-torre (paralelo)\n";
+        std::cout << "7. Salir\n";
         std::cout << "Seleccione una opcion: ";
         std::cin >> choice;
 
-        if (std::cin.fail() || choice < 1 || choice > 3) {
+        if (std::cin.fail() || choice < 1 || choice > 7) {
             std::cin.clear();
             clearInputBuffer();
             std::cout << "Opcion no valida. Intente nuevamente.\n";
@@ -74,6 +87,8 @@ void trainWithDefaultParams() {
     Y_train *= (1.0f / 198.0f);
 
 
+    //Declarado antes que la red: el sink que ella guarda escribe aqui hasta destruirse
+    std::ofstream metrics_file("metricas_entrenamiento.csv");
     NeuralNetwork<float> nn;
     nn.add_layer(std::make_unique<Dense<float>>(2, 64));
     nn.add_layer(std::make_unique<ReLU<float>>());
@@ -85,6 +100,11 @@ void trainWithDefaultParams() {
 
     nn.set_optimizer(std::make_unique<Adam<float>>(0.001));
 
+    //Metricas por lote en CSV; el resumen por epoca sale por consola
+    auto metrics = std::make_shared<MetricsSink>();
+    metrics->set_output(metrics_file);
+    nn.set_metrics_sink(metrics);
+
     auto start_time = high_resolution_clock::now();
 
     std::cout << "\n=== PROCESO DE ENTRENAMIENTO ===\n";
@@ -98,6 +118,7 @@ void trainWithDefaultParams() {
     std::cout << "\n=== TIEMPO DE ENTRENAMIENTO ===\n";
     std::cout << "Tiempo total: " << duration.count() << " milisegundos\n";
     std::cout << "Tiempo por epoca: " << duration.count()/15.0 << " ms/epoca\n";
+    std::cout << "Metricas por lote: metricas_entrenamiento.csv\n";
 
     std::cout << "\n=== PRUEBAS AUTOMATICAS ===\n";
     std::vector<std::pair<int, int>> test_cases = {
@@ -131,7 +152,8 @@ void trainWithDefaultParams() {
 }
 
 void getCustomParam(size_t& epochs, size_t& batch_size, float& learning_rate,
-                   size_t& layer1_size, size_t& layer2_size, size_t& layer3_size) {
+                   size_t& layer1_size, size_t& layer2_size, size_t& layer3_size,
+                   size_t& checkpoint_segment) {
     std::cout << "\n=== CONFIGURACION PERSONALIZADA ===\n";
     std::cout << "Ingrese los parametros (presione Enter para usar valores por defecto):\n";
 
@@ -159,13 +181,18 @@ void getCustomParam(size_t& epochs, size_t& batch_size, float& learning_rate,
     std::cout << "Neuronas en tercera capa oculta (default 16): ";
     std::getline(std::cin, input);
     layer3_size = input.empty() ? 16 : std::stoul(input);
+
+    std::cout << "Capas por segmento de checkpointing (default 0 = desactivado): ";
+    std::getline(std::cin, input);
+    checkpoint_segment = input.empty() ? 0 : std::stoul(input);
 }
 
 void trainWithCustomParams() {
-    size_t epochs, batch_size, layer1_size, layer2_size, layer3_size;
+    size_t epochs, batch_size, layer1_size, layer2_size, layer3_size, checkpoint_segment;
     float learning_rate;
 
-    getCustomParam(epochs, batch_size, learning_rate, layer1_size, layer2_size, layer3_size);
+    getCustomParam(epochs, batch_size, learning_rate, layer1_size, layer2_size, layer3_size,
+                   checkpoint_segment);
 
     std::cout << "\n=== RESUMEN DE CONFIGURACION ===\n";
     std::cout << "Epocas: " << epochs << "\n";
@@ -174,6 +201,9 @@ void trainWithCustomParams() {
     std::cout << "Neuronas capa 1: " << layer1_size << "\n";
     std::cout << "Neuronas capa 2: " << layer2_size << "\n";
     std::cout << "Neuronas capa 3: " << layer3_size << "\n";
+    std::cout << "Checkpointing: "
+              << (checkpoint_segment ? std::to_string(checkpoint_segment) + " capas por segmento" : "desactivado")
+              << "\n";
 
     auto [X_train, Y_train] = generate_data(1000);
 
@@ -183,6 +213,8 @@ void trainWithCustomParams() {
     Y_train *= (1.0f / 198.0f);
 
 
+    //Declarado antes que la red: el sink que ella guarda escribe aqui hasta destruirse
+    std::ofstream metrics_file("metricas_entrenamiento.csv");
     NeuralNetwork<float> nn;
     nn.add_layer(std::make_unique<Dense<float>>(2, layer1_size));
     nn.add_layer(std::make_unique<ReLU<float>>());
@@ -193,6 +225,14 @@ void trainWithCustomParams() {
     nn.add_layer(std::make_unique<Dense<float>>(layer3_size, 1));
 
     nn.set_optimizer(std::make_unique<Adam<float>>(learning_rate));
+    if (checkpoint_segment > 0) {
+        nn.enable_checkpointing(checkpoint_segment);
+    }
+
+    //Metricas por lote en CSV; el resumen por epoca sale por consola
+    auto metrics = std::make_shared<MetricsSink>();
+    metrics->set_output(metrics_file);
+    nn.set_metrics_sink(metrics);
 
     auto start_time = high_resolution_clock::now();
 
@@ -207,6 +247,8 @@ void trainWithCustomParams() {
     std::cout << "\n=== TIEMPO DE ENTRENAMIENTO ===\n";
     std::cout << "Tiempo total: " << duration.count() << " milisegundos\n";
     std::cout << "Tiempo por epoca: " << duration.count()/static_cast<float>(epochs) << " ms/epoca\n";
+    std::cout << "Pico de memoria de activaciones: " << nn.peak_activation_bytes() / 1024.0 << " KB\n";
+    std::cout << "Metricas por lote: metricas_entrenamiento.csv\n";
 
     std::cout << "\n=== PRUEBAS AUTOMATICAS ===\n";
     std::vector<std::pair<int, int>> test_cases = {
@@ -238,6 +280,52 @@ void trainWithCustomParams() {
     float accuracy = (static_cast<float>(correct) / test_cases.size()) * 100.0f;
     std::cout << "Precision total: " << accuracy << "%\n";
 
+#if defined(__unix__)
+    //El dominio de entrada son enteros 0-99 normalizados: 10.000 puntos en total.
+    //La tabla se mapea con mmap, por eso solo en sistemas Unix
+    std::cout << "\n=== TABLA DE CONSULTA ===\n";
+    auto lut_start = high_resolution_clock::now();
+    DiscreteAxis<float> axis{0.0f, 1.0f / 99.0f, 100};
+    LookupTable<float>::compile(nn, {axis, axis}).save("tabla_suma.lut");
+    auto table = LookupTable<float>::map("tabla_suma.lut", &nn);
+    auto lut_ms = duration_cast<milliseconds>(high_resolution_clock::now() - lut_start).count();
+
+    std::vector<float> net_outputs;
+    net_outputs.reserve(table.entries());
+    auto net_start = high_resolution_clock::now();
+    for (int a = 0; a < 100; ++a) {
+        for (int b = 0; b < 100; ++b) {
+            Tensor<float,2> input(1, 2);
+            input.at(0, 0) = a / 99.0f;
+            input.at(0, 1) = b / 99.0f;
+            net_outputs.push_back(nn.forward(input).at(0, 0));
+        }
+    }
+    auto net_end = high_resolution_clock::now();
+    std::vector<float> lut_outputs;
+    lut_outputs.reserve(table.entries());
+    for (int a = 0; a < 100; ++a) {
+        for (int b = 0; b < 100; ++b) {
+            float point[2] = {a / 99.0f, b / 99.0f};
+            lut_outputs.push_back(*table.find(point));
+        }
+    }
+    auto lut_end = high_resolution_clock::now();
+
+    float max_diff = 0;
+    for (size_t i = 0; i < net_outputs.size(); ++i) {
+        max_diff = std::max(max_diff, std::abs(net_outputs[i] - lut_outputs[i]) * 198.0f);
+    }
+
+    std::cout << "Entradas: " << table.entries() << " (archivo tabla_suma.lut, " << lut_ms << " ms en generarla)\n";
+    std::cout << "Memoria de la tabla: " << table.memory_bytes() / 1024.0 << " KB\n";
+    std::cout << "Latencia por consulta (red): "
+              << std::chrono::duration<double, std::micro>(net_end - net_start).count() / 10000 << " us\n";
+    std::cout << "Latencia por consulta (tabla): "
+              << std::chrono::duration<double, std::micro>(lut_end - net_end).count() / 10000 << " us\n";
+    std::cout << "Diferencia maxima red vs tabla: " << max_diff << "\n";
+#endif
+
     std::cout << "\n=== MODO INTERACTIVO ===\n";
     std::cout << "Ingrese dos numeros entre 0 y 99 para que la red los sume (o -1 para salir)\n";
 
@@ -269,7 +357,11 @@ void trainWithCustomParams() {
         input.at(0, 0) = a / 99.0f;
         input.at(0, 1) = b / 99.0f;
 
+#if defined(__unix__)
+        auto output = table.predict(input);
+#else
         auto output = nn.forward(input);
+#endif
         float predicted = output.at(0,0) * 198.0f;
 
         std::cout << "\n=== SUMA ===\n";
@@ -283,6 +375,243 @@ void trainWithCustomParams() {
     }
 }
 
+//Referencia densa con el mismo recorrido que la capa CSR (filas de W por
+//cada entrada), para comparar formatos y no implementaciones
+void denseForwardReference(const Tensor<float,2>& x, const Dense<float>& layer, Tensor<float,2>& out) {
+    size_t batch = x.shape()[0], in_feats = layer.W.shape()[0], out_feats = layer.W.shape()[1];
+    const float* w = layer.W.data();
+    for (size_t i = 0; i < batch; ++i) {
+        float* out_row = out.data() + i * out_feats;
+        for (size_t j = 0; j < out_feats; ++j) {
+            out_row[j] = layer.b.data()[j];
+        }
+        const float* x_row = x.data() + i * in_feats;
+        for (size_t k = 0; k < in_feats; ++k) {
+            float xv = x_row[k];
+            const float* w_row = w + k * out_feats;
+            for (size_t j = 0; j < out_feats; ++j) {
+                out_row[j] += xv * w_row[j];
+            }
+        }
+    }
+}
+
+//Menor sparsity a partir de la cual la dispersa gana en todas las mediciones
+//siguientes, o -1 si no gana en la ultima
+double sparseCrossover(const std::vector<std::pair<double, bool>>& sparse_wins) {
+    double crossover = -1.0;
+    for (auto it = sparse_wins.rbegin(); it != sparse_wins.rend() && it->second; ++it) {
+        crossover = it->first;
+    }
+    return crossover;
+}
+
+void benchmarkSparse() {
+    std::cout << "\n=== BENCHMARK DENSA VS DISPERSA ===\n";
+    const size_t batch = 64, in_feats = 512, out_feats = 512, reps = 5;
+    std::cout << "Capa " << in_feats << "x" << out_feats << ", lote " << batch
+              << ", " << reps << " repeticiones\n\n";
+
+    Tensor<float,2> x(batch, in_feats);
+    x.fill_random(-1.0f, 1.0f);
+    Tensor<float,2> reference_out(batch, out_feats);
+
+    std::cout << "Sparsity\tDensa ref(ms)\tDensa opt(ms)\tDispersa(ms)\tSpeedup ref\tMem densa(KB)\tMem CSR(KB)\n";
+    std::vector<std::pair<double, bool>> wins_vs_reference, wins_vs_tuned;
+    for (double sparsity : {0.0, 0.5, 0.7, 0.8, 0.9, 0.95, 0.99}) {
+        Dense<float> dense(in_feats, out_feats);
+        prune_magnitude(dense.W, sparsity);
+        SparseDense<float> sparse(dense);
+
+        //Calentamiento: caches y autotuning fuera de la medicion
+        denseForwardReference(x, dense, reference_out);
+        dense.forward(x);
+        sparse.forward(x);
+
+        auto t0 = high_resolution_clock::now();
+        for (size_t r = 0; r < reps; ++r) denseForwardReference(x, dense, reference_out);
+        auto t1 = high_resolution_clock::now();
+        for (size_t r = 0; r < reps; ++r) dense.forward(x);
+        auto t2 = high_resolution_clock::now();
+        for (size_t r = 0; r < reps; ++r) sparse.forward(x);
+        auto t3 = high_resolution_clock::now();
+
+        double reference_ms = duration<double, std::milli>(t1 - t0).count() / reps;
+        double tuned_ms = duration<double, std::milli>(t2 - t1).count() / reps;
+        double sparse_ms = duration<double, std::milli>(t3 - t2).count() / reps;
+        wins_vs_reference.emplace_back(sparsity, sparse_ms < reference_ms);
+        wins_vs_tuned.emplace_back(sparsity, sparse_ms < tuned_ms);
+
+        std::cout << sparsity << "\t\t" << reference_ms << "\t\t" << tuned_ms << "\t\t" << sparse_ms << "\t\t"
+                  << reference_ms / sparse_ms << "\t\t" << sparse.dense_memory_bytes() / 1024.0 << "\t\t"
+                  << sparse.memory_bytes() / 1024.0 << "\n";
+    }
+
+    std::cout << "\n";
+    for (auto [label, wins] : {std::make_pair("densa de referencia", &wins_vs_reference),
+                               std::make_pair("densa optimizada", &wins_vs_tuned)}) {
+        double crossover = sparseCrossover(*wins);
+        if (crossover >= 0) {
+            std::cout << "La capa dispersa supera a la " << label << " desde sparsity " << crossover << "\n";
+        } else {
+            std::cout << "La capa dispersa no supero a la " << label << " en este rango\n";
+        }
+    }
+}
+
+//Precision sobre los casos de prueba fijos (error <= 0.3)
+template <typename Model>
+float sumTestAccuracy(Model& nn) {
+    std::vector<std::pair<int, int>> test_cases = {
+        {1,1}, {4,23}, {7,8}, {10,20}, {50,50}, {99,99},
+        {12,45}, {78,21}, {5,95}, {33,66}, {9,89}, {45,55}
+    };
+    int correct = 0;
+    for (auto [a, b] : test_cases) {
+        Tensor<float,2> input(1, 2);
+        input.at(0, 0) = a / 99.0f;
+        input.at(0, 1) = b / 99.0f;
+        float predicted = nn.forward(input).at(0, 0) * 198.0f;
+        if (std::abs(predicted - (a + b)) <= 0.3) {
+            correct++;
+        }
+    }
+    return (static_cast<float>(correct) / test_cases.size()) * 100.0f;
+}
+
+//Usa fork, memoria compartida POSIX y sockets: solo en sistemas Unix
+void trainDataParallel() {
+    std::cout << "\n=== ENTRENAMIENTO DATA-PARALLEL ===\n";
+#if defined(__unix__)
+    std::string input;
+    std::cout << "Numero de procesos (default 4): ";
+    std::getline(std::cin, input);
+    size_t workers = input.empty() ? 4 : std::stoul(input);
+
+    std::cout << "Transporte: 1 = memoria compartida, 2 = TCP loopback (default 1): ";
+    std::getline(std::cin, input);
+    auto kind = input == "2" ? RingTransportKind::Tcp : RingTransportKind::SharedMemory;
+
+    std::cout << "Numero de epocas (default 15): ";
+    std::getline(std::cin, input);
+    size_t epochs = input.empty() ? 15 : std::stoul(input);
+
+    auto [X_train, Y_train] = generate_data(1000);
+    X_train *= (1.0f / 99.0f);
+    Y_train *= (1.0f / 198.0f);
+
+    NeuralNetwork<float> nn;
+    nn.add_layer(std::make_unique<Dense<float>>(2, 64));
+    nn.add_layer(std::make_unique<ReLU<float>>());
+    nn.add_layer(std::make_unique<Dense<float>>(64, 32));
+    nn.add_layer(std::make_unique<ReLU<float>>());
+    nn.add_layer(std::make_unique<Dense<float>>(32, 16));
+    nn.add_layer(std::make_unique<ReLU<float>>());
+    nn.add_layer(std::make_unique<Dense<float>>(16, 1));
+    nn.set_optimizer(std::make_unique<Adam<float>>(0.001));
+
+    std::cout << "\n=== PROCESO DE ENTRENAMIENTO (" << workers << " procesos, "
+              << (kind == RingTransportKind::Tcp ? "TCP" : "memoria compartida") << ") ===\n";
+    auto start_time = high_resolution_clock::now();
+    try {
+        DataParallelTrainer<float>(workers, kind).train(nn, X_train, Y_train, epochs, 32);
+    } catch (const std::exception& e) {
+        std::cout << "Error en el entrenamiento: " << e.what() << "\n";
+        return;
+    }
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start_time);
+
+    std::cout << "\nTiempo total: " << duration.count() << " milisegundos\n";
+    std::cout << "Precision total: " << sumTestAccuracy(nn) << "%\n";
+#else
+    std::cout << "No disponible en esta plataforma (requiere fork y memoria compartida POSIX)\n";
+#endif
+}
+
+void sweepHyperparams() {
+    std::cout << "\n=== BARRIDO DE HIPERPARAMETROS ===\n";
+    std::string input;
+    std::cout << "Semillas por tasa de aprendizaje (default 4): ";
+    std::getline(std::cin, input);
+    unsigned seeds = input.empty() ? 4 : std::stoul(input);
+
+    std::cout << "Numero de epocas (default 15): ";
+    std::getline(std::cin, input);
+    size_t epochs = input.empty() ? 15 : std::stoul(input);
+
+    std::vector<SweepConfig<float>> configs;
+    for (float lr : {0.0005f, 0.001f, 0.003f, 0.01f}) {
+        for (unsigned seed = 0; seed < seeds; ++seed) {
+            SweepConfig<float> config;
+            config.seed = seed;
+            config.learning_rate = lr;
+            configs.push_back(config);
+        }
+    }
+
+    auto [X_train, Y_train] = generate_data(1000);
+    X_train *= (1.0f / 99.0f);
+    Y_train *= (1.0f / 198.0f);
+
+    ModelSweep<float> sweep({2, 64, 32, 16, 1}, configs);
+    std::cout << "Entrenando " << sweep.size() << " modelos 2-64-32-16-1 (Adam, lote 32)...\n";
+    auto result = sweep.train(X_train, Y_train, epochs, 32);
+
+    std::cout << "\nModelo\tTasa\tSemilla\tPerdida inicial\tPerdida final\tPrecision\n";
+    size_t best = 0;
+    for (size_t m = 0; m < sweep.size(); ++m) {
+        const auto& curve = result.loss_curves[m];
+        if (curve.back() < result.loss_curves[best].back()) best = m;
+        auto nn = sweep.to_network(m);
+        std::cout << m << "\t" << configs[m].learning_rate << "\t" << configs[m].seed << "\t"
+                  << curve.front() << "\t" << curve.back() << "\t" << sumTestAccuracy(nn) << "%\n";
+    }
+
+    std::cout << "\nMejor modelo: " << best << " (tasa " << configs[best].learning_rate
+              << ", semilla " << configs[best].seed << ")\n";
+    std::cout << "Tiempo total: " << result.wall_ms << " milisegundos ("
+              << result.wall_ms / sweep.size() << " ms/modelo)\n";
+}
+
+void trainGraphModel() {
+    std::cout << "\n=== MODELO EN GRAFO MULTI-TORRE ===\n";
+    std::string input;
+    std::cout << "Numero de epocas (default 15): ";
+    std::getline(std::cin, input);
+    size_t epochs = input.empty() ? 15 : std::stoul(input);
+
+    auto [X_train, Y_train] = generate_data(1000);
+    X_train *= (1.0f / 99.0f);
+    Y_train *= (1.0f / 198.0f);
+
+    //Dos torres independientes que se concatenan, con un atajo residual
+    //desde la torre A sumado antes de la capa de salida
+    GraphModel<float> model;
+    auto x = model.add_input();
+    auto a = model.add_layer(std::make_unique<Dense<float>>(2, 64), x);
+    a = model.add_layer(std::make_unique<ReLU<float>>(), a);
+    a = model.add_layer(std::make_unique<Dense<float>>(64, 16), a);
+    a = model.add_layer(std::make_unique<ReLU<float>>(), a);
+    auto b = model.add_layer(std::make_unique<Dense<float>>(2, 64), x);
+    b = model.add_layer(std::make_unique<ReLU<float>>(), b);
+    b = model.add_layer(std::make_unique<Dense<float>>(64, 16), b);
+    b = model.add_layer(std::make_unique<ReLU<float>>(), b);
+    auto merged = model.add_concat({a, b});
+    auto hidden = model.add_layer(std::make_unique<Dense<float>>(32, 16), merged);
+    hidden = model.add_layer(std::make_unique<ReLU<float>>(), hidden);
+    auto residual = model.add_add({hidden, a});
+    model.set_output(model.add_layer(std::make_unique<Dense<float>>(16, 1), residual));
+    model.set_optimizer(std::make_unique<Adam<float>>(0.001));
+
+    std::cout << "\n=== PROCESO DE ENTRENAMIENTO ===\n";
+    auto start_time = high_resolution_clock::now();
+    model.train({X_train}, Y_train, epochs, 32);
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start_time);
+
+    std::cout << "\nTiempo total: " << duration.count() << " milisegundos\n";
+    std::cout << "Precision total: " << sumTestAccuracy(model) << "%\n";
+}
+
 int main() {
     std::cout << "RED NEURONAL PARA SUMAR NUMEROS DE 2 DIGITOS (0-99)\n";
 
@@ -297,6 +626,18 @@ int main() {
                 trainWithCustomParams();
                 break;
             case 3:
+                benchmarkSparse();
+                break;
+            case 4:
+                trainDataParallel();
+                break;
+            case 5:
+                sweepHyperparams();
+                break;
+            case 6:
+                trainGraphModel();
+                break;
+            case 7:
                 std::cout << "Saliendo del programa...\n";
                 return 0;
         }
@@ -4,8 +4,14 @@
 #include "nn_optimizer.h"
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 #include "nn_dense.h"
+#include "nn_sparse.h"
+#include "nn_metrics.h"
 
 namespace utec::neural_network {
     using namespace algebra;
@@ -14,6 +20,123 @@ class NeuralNetwork {
     std::vector<std::unique_ptr<ILayer<T>>> layers;
     MSELoss<T> criterion;
 
+    //Mascaras de poda: mantienen en cero los pesos podados despues de cada update
+    std::unordered_map<Dense<T>*, Tensor<T,2>> prune_masks;
+    double prune_final_sparsity = 0.0;
+    size_t prune_start_epoch = 0, prune_end_epoch = 0;
+
+    void prune_layer(Dense<T>& dense, double sparsity) {
+        prune_magnitude(dense.W, sparsity);
+        auto& mask = prune_masks[&dense];
+        mask = Tensor<T,2>(dense.W.shape()[0], dense.W.shape()[1]);
+        for (size_t i = 0; i < dense.W.size(); ++i) {
+            mask.data()[i] = dense.W.data()[i] != 0 ? 1 : 0;
+        }
+    }
+
+    size_t checkpoint_every = 0;
+    std::vector<size_t> checkpoint_bounds;
+    std::vector<Tensor<T,2>> checkpoints;
+    size_t peak_activation_bytes_ = 0;
+
+    std::unique_ptr<IGradientReducer<T>> reducer;
+    std::shared_ptr<MetricsSink> metrics;
+
+    //Norma L2 de todos los gradientes de las capas Dense
+    double gradient_norm() {
+        double sum = 0;
+        for (auto dense : dense_layers()) {
+            for (size_t i = 0; i < dense->dW.size(); ++i) sum += dense->dW.data()[i] * dense->dW.data()[i];
+            for (size_t i = 0; i < dense->db.size(); ++i) sum += dense->db.data()[i] * dense->db.data()[i];
+        }
+        return std::sqrt(sum);
+    }
+
+    Tensor<T,2> backward_layer(ILayer<T>& layer, const Tensor<T,2>& grad) {
+        Tensor<T,2> input_grad = layer.backward(grad);
+        if (reducer) {
+            if (auto dense = dynamic_cast<Dense<T>*>(&layer)) {
+                reducer->on_gradient_ready(dense->dW, dense->db);
+            }
+        }
+        return input_grad;
+    }
+
+    std::vector<size_t> segment_starts() const {
+        if (!checkpoint_bounds.empty()) {
+            std::vector<size_t> starts;
+            for (size_t b : checkpoint_bounds) {
+                if (b < layers.size()) starts.push_back(b);
+            }
+            return starts;
+        }
+        std::vector<size_t> starts;
+        for (size_t i = 0; i < layers.size(); i += checkpoint_every) {
+            starts.push_back(i);
+        }
+        return starts;
+    }
+
+    void track_activation_bytes() {
+        size_t bytes = 0;
+        for (auto& layer : layers) {
+            bytes += layer->cache_bytes();
+        }
+        for (auto& checkpoint : checkpoints) {
+            bytes += checkpoint.size() * sizeof(T);
+        }
+        peak_activation_bytes_ = std::max(peak_activation_bytes_, bytes);
+    }
+
+    Tensor<T,2> forward_checkpointed(const Tensor<T,2>& x) {
+        auto starts = segment_starts();
+        checkpoints.clear();
+        for (auto& layer : layers) {
+            layer->release_cache();
+        }
+        Tensor<T,2> output = x;
+        for (size_t s = 0; s < starts.size(); ++s) {
+            size_t end = s + 1 < starts.size() ? starts[s + 1] : layers.size();
+            //El ultimo segmento no se recalcula: su entrada no se guarda
+            if (s + 1 < starts.size()) {
+                checkpoints.push_back(output);
+            }
+            for (size_t i = starts[s]; i < end; ++i) {
+                output = layers[i]->forward(output);
+            }
+            track_activation_bytes();
+            //El ultimo segmento conserva sus caches: backward empieza por el
+            if (s + 1 < starts.size()) {
+                for (size_t i = starts[s]; i < end; ++i) {
+                    layers[i]->release_cache();
+                }
+            }
+        }
+        return output;
+    }
+
+    void backward_checkpointed(const Tensor<T,2>& grad) {
+        auto starts = segment_starts();
+        Tensor<T,2> current_grad = grad;
+        for (size_t s = starts.size(); s-- > 0;) {
+            size_t end = s + 1 < starts.size() ? starts[s + 1] : layers.size();
+            if (s + 1 < starts.size()) {
+                //Recomputo del segmento a partir de su checkpoint
+                Tensor<T,2> output = checkpoints[s];
+                for (size_t i = starts[s]; i < end; ++i) {
+                    output = layers[i]->forward(output);
+                }
+                track_activation_bytes();
+            }
+            for (size_t i = end; i-- > starts[s];) {
+                current_grad = backward_layer(*layers[i], current_grad);
+                layers[i]->release_cache();
+            }
+            if (s + 1 < starts.size()) {
+                checkpoints.pop_back();
+            }
+        }
+    }
 
 public:
     std::unique_ptr<IOptimizer<T>> optimizer;
@@ -26,30 +149,158 @@ public:
         optimizer = std::move(opt);
     }
 
+    //Con un sink, train publica metricas por lote y el sink imprime el
+    //resumen por epoca; nullptr vuelve a la salida por consola
+    void set_metrics_sink(std::shared_ptr<MetricsSink> sink) {
+        metrics = std::move(sink);
+    }
+
+    //nullptr desactiva la reduccion de gradientes
+    void set_gradient_reducer(std::unique_ptr<IGradientReducer<T>> r) {
+        reducer = std::move(r);
+    }
+
+    std::vector<Dense<T>*> dense_layers() {
+        std::vector<Dense<T>*> result;
+        for (auto& layer : layers) {
+            if (auto dense = dynamic_cast<Dense<T>*>(layer.get())) {
+                result.push_back(dense);
+            }
+        }
+        return result;
+    }
+
+    //Poda de una sola vez: cada capa Dense queda con la sparsity indicada
+    void prune(double sparsity) {
+        for (auto dense : dense_layers()) {
+            prune_layer(*dense, sparsity);
+        }
+    }
+
+    //Poda gradual durante train: entre start_epoch y end_epoch la sparsity
+    //sube hasta final_sparsity siguiendo pruning_target
+    void set_pruning_schedule(double final_sparsity, size_t start_epoch, size_t end_epoch) {
+        if (!(final_sparsity >= 0 && final_sparsity <= 1)) {
+            throw std::invalid_argument("Pruning final_sparsity must be in [0, 1]");
+        }
+        if (end_epoch < start_epoch) {
+            throw std::invalid_argument("Pruning end_epoch must be >= start_epoch");
+        }
+        prune_final_sparsity = final_sparsity;
+        prune_start_epoch = start_epoch;
+        prune_end_epoch = end_epoch;
+    }
+
+    //Se llama al final de cada epoca de entrenamiento
+    void apply_pruning_schedule(size_t epoch) {
+        if (prune_final_sparsity > 0 && epoch >= prune_start_epoch) {
+            prune(pruning_target(prune_final_sparsity, epoch, prune_start_epoch, prune_end_epoch));
+        }
+    }
+
+    //Reemplaza cada Dense por un SparseDense (CSR) para inferencia
+    void sparsify() {
+        for (auto& layer : layers) {
+            if (auto dense = dynamic_cast<Dense<T>*>(layer.get())) {
+                layer = std::make_unique<SparseDense<T>>(*dense);
+            }
+        }
+        prune_masks.clear();
+    }
+
+    //Checkpointing: solo se guardan las entradas de cada segmento y en backward
+    //se recalcula el forward del segmento antes de propagar el gradiente
+    void enable_checkpointing(size_t layers_per_segment) {
+        if (layers_per_segment == 0) {
+            throw std::invalid_argument("layers_per_segment must be > 0");
+        }
+        checkpoint_every = layers_per_segment;
+        checkpoint_bounds.clear();
+    }
+
+    //Segmentacion explicita: indices de capa donde empieza cada segmento
+    void set_checkpoint_boundaries(std::vector<size_t> bounds) {
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+        if (bounds.empty() || bounds.front() != 0) {
+            bounds.insert(bounds.begin(), 0);
+        }
+        checkpoint_bounds = std::move(bounds);
+        checkpoint_every = 0;
+    }
+
+    void disable_checkpointing() {
+        checkpoint_every = 0;
+        checkpoint_bounds.clear();
+        checkpoints.clear();
+    }
+
+    bool checkpointing() const { return checkpoint_every > 0 || !checkpoint_bounds.empty(); }
+
+    //Maximo de bytes de activaciones guardadas (caches de capas + checkpoints)
+    size_t peak_activation_bytes() const { return peak_activation_bytes_; }
+    void reset_peak_activation_bytes() { peak_activation_bytes_ = 0; }
+
     Tensor<T,2> forward(const Tensor<T,2>& x) {
+        if (checkpointing()) {
+            return forward_checkpointed(x);
+        }
         Tensor<T,2> output = x;
         for (auto& layer : layers) {
             output = layer->forward(output);
         }
+        track_activation_bytes();
         return output;
     }
 
     void backward(const Tensor<T,2>& grad) {
+        //Solo si el ultimo forward guardo un checkpoint por segmento recalculable
+        if (checkpointing() && checkpoints.size() + 1 == segment_starts().size()) {
+            backward_checkpointed(grad);
+            return;
+        }
         Tensor<T,2> current_grad = grad;
         for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
-            current_grad = (*it)->backward(current_grad);
+            current_grad = backward_layer(**it, current_grad);
         }
     }
 
     void optimize() {
+        if (reducer) {
+            reducer->synchronize();
+        }
         for (auto& layer : layers) {
             if (auto dense = dynamic_cast<Dense<T>*>(layer.get())) {
                 optimizer->update(dense->W, dense->dW);
                 optimizer->update(dense->b, dense->db);
+
+                auto mask = prune_masks.find(dense);
+                if (mask != prune_masks.end()) {
+                    T* w = dense->W.data();
+                    const T* m = mask->second.data();
+                    for (size_t i = 0; i < dense->W.size(); ++i) {
+                        w[i] *= m[i];
+                    }
+                }
             }
         }
     }
 
+    //Un paso de entrenamiento sobre un lote; devuelve la perdida del lote
+    T train_step(const Tensor<T,2>& x_batch, const Tensor<T,2>& y_batch) {
+        // Forward pass
+        Tensor<T,2> output = forward(x_batch);
+        T loss = criterion.forward(output, y_batch);
+
+        // Backward pass
+        Tensor<T,2> grad = criterion.backward();
+        backward(grad);
+
+        // Update parameters
+        optimize();
+        return loss;
+    }
+
     void train(const Tensor<T,2>& X, const Tensor<T,2>& Y, size_t epochs, size_t batch_size = 32) {
         for (size_t epoch = 0; epoch < epochs; ++epoch) {
             T total_loss = 0;
@@ -58,24 +309,37 @@ public:
             for (size_t batch = 0; batch < num_batches; ++batch) {
                 size_t start = batch * batch_size;
                 size_t end = std::min(start + batch_size, X.shape()[0]);
-                Tensor<T,2> x_batch = X.slice(start, end);
-               Tensor<T,2> y_batch = Y.slice(start, end);
-
-                // Forward pass
-                Tensor<T,2> output = forward(x_batch);
-                T loss = criterion.forward(output, y_batch);
+                auto step_start = std::chrono::steady_clock::now();
+                T loss = train_step(X.slice(start, end), Y.slice(start, end));
                 total_loss += loss;
 
-                // Backward pass
-                Tensor<T,2> grad = criterion.backward();
-                backward(grad);
-
-                // Update parameters
-                optimize();
+                if (metrics) {
+                    double step_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - step_start).count();
+                    MetricRecord record;
+                    record.epoch = epoch;
+                    record.epochs = epochs;
+                    record.batch = batch;
+                    record.batches = num_batches;
+                    record.loss = loss;
+                    record.grad_norm = gradient_norm();
+                    record.step_ms = step_ms;
+                    record.samples_per_sec = (end - start) * 1000.0 / step_ms;
+                    metrics->push(record);
+                }
             }
 
-            std::cout << "Epoch " << epoch + 1 << "/" << epochs
-                      << ", Loss: " << total_loss / num_batches << std::endl;
+            apply_pruning_schedule(epoch);
+
+            if (metrics) {
+                metrics->end_epoch(epoch, epochs, total_loss / num_batches);
+            } else {
+                std::cout << "Epoch " << epoch + 1 << "/" << epochs
+                          << ", Loss: " << total_loss / num_batches << "\n";
+            }
+        }
+        if (metrics) {
+            metrics->flush();
         }
     }
 };
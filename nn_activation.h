@@ -1,6 +1,8 @@
 #pragma once
 #include "tensor.h"
 #include "nn_layer.h"
+#include "nn_autotune.h"
+#include <stdexcept>
 
 namespace utec::neural_network {
 
@@ -9,27 +11,29 @@ namespace utec::neural_network {
         Tensor<T,2> mask;
     public:
         Tensor<T,2> forward(const Tensor<T,2>& x) override {
+            if (x.shape().size() != 2) {
+                throw std::invalid_argument("ReLU expects a 2D input");
+            }
             Tensor<T,2> result(x.shape()[0], x.shape()[1]);
             mask = Tensor<T,2>(x.shape()[0], x.shape()[1]);
 
-            for (size_t i = 0; i < x.shape()[0]; ++i) {
-                for (size_t j = 0; j < x.shape()[1]; ++j) {
-                    mask.at(i, j) = x.at(i, j) > 0 ? 1 : 0;
-                    result.at(i, j) = x.at(i, j) * mask.at(i, j);
-                }
-            }
+            auto cfg = Autotuner::instance().elementwise<T>(x.size());
+            relu_forward(x.data(), result.data(), mask.data(), x.size(), cfg);
             return result;
         }
 
         Tensor<T,2> backward(const Tensor<T,2>& grad) override {
-            Tensor<T,2> result(grad.shape()[0], grad.shape()[1]);
-            for (size_t i = 0; i < grad.shape()[0]; ++i) {
-                for (size_t j = 0; j < grad.shape()[1]; ++j) {
-                    result.at(i, j) = grad.at(i, j) * mask.at(i, j);
-                }
+            if (grad.shape() != mask.shape()) {
+                throw std::invalid_argument("Gradient shape doesn't match the last ReLU forward");
             }
+            Tensor<T,2> result(grad.shape()[0], grad.shape()[1]);
+            auto cfg = Autotuner::instance().elementwise<T>(grad.size());
+            relu_backward(grad.data(), mask.data(), result.data(), grad.size(), cfg);
             return result;
         }
+
+        size_t cache_bytes() const override { return mask.size() * sizeof(T); }
+        void release_cache() override { mask = Tensor<T,2>(); }
     };
 
 } // namespace utec::neural_network
\ No newline at end of file
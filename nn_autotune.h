@@ -0,0 +1,271 @@
+#pragma once
+#include "nn_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace utec::neural_network {
+
+//Autotuning de los kernels: la primera vez que aparece una forma se miden
+//las configuraciones candidatas y se guarda la mas rapida en un archivo de
+//cache (una linea por entrada: cpu <TAB> clave <TAB> valores). Las entradas de
+//otra CPU se conservan en el archivo pero no se usan. El tamano de lote (M, o
+//n en los kernels elemento a elemento) se agrupa en potencias de dos, asi un
+//lote final mas corto reutiliza la entrada del lote completo.
+class Autotuner {
+public:
+    static Autotuner& instance() {
+        static Autotuner tuner;
+        return tuner;
+    }
+
+    //Desactivado devuelve la configuracion por defecto sin medir
+    void set_enabled(bool value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        enabled = value;
+    }
+
+    //Congelado solo usa lo ya medido: formas nuevas reciben la configuracion
+    //por defecto y no se mide ni se escribe el archivo (procesos hijos que
+    //comparten la cache con el padre)
+    void set_frozen(bool value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        frozen = value;
+    }
+
+    void set_cache_path(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mtx);
+        cache_path = path;
+        loaded = false;
+        matmul_cache.clear();
+        elementwise_cache.clear();
+    }
+
+    const std::string& cpu() const { return cpu_model; }
+
+    //Lote redondeado a la siguiente potencia de dos
+    static size_t bucket(size_t n) {
+        size_t b = 1;
+        while (b < n) b *= 2;
+        return b;
+    }
+
+    template <typename T>
+    MatmulConfig matmul(size_t M, size_t K, size_t N, MatmulOp op = MatmulOp::Forward) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!enabled) return MatmulConfig{};
+        load();
+        M = bucket(M);
+        std::string key = std::string(op_name(op)) + ":" + type_name<T>() + ":" + std::to_string(M) + "x" +
+                          std::to_string(K) + "x" + std::to_string(N);
+        auto it = matmul_cache.find(key);
+        if (it != matmul_cache.end()) return it->second;
+        if (frozen) return MatmulConfig{};
+
+        MatmulConfig best = tune_matmul<T>(op, M, K, N);
+        matmul_cache[key] = best;
+        append(key, {best.tile_k, best.tile_j, best.row_block, best.threads});
+        return best;
+    }
+
+    template <typename T>
+    ElementwiseConfig elementwise(size_t n) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!enabled) return ElementwiseConfig{};
+        load();
+        n = bucket(n);
+        std::string key = "relu:" + type_name<T>() + ":" + std::to_string(n);
+        auto it = elementwise_cache.find(key);
+        if (it != elementwise_cache.end()) return it->second;
+        if (frozen) return ElementwiseConfig{};
+
+        ElementwiseConfig best = tune_elementwise<T>(n);
+        elementwise_cache[key] = best;
+        append(key, {best.threads});
+        return best;
+    }
+
+private:
+    std::mutex mtx;
+    bool enabled = true;
+    bool frozen = false;
+    bool loaded = false;
+    std::string cache_path;
+    std::string cpu_model;
+    std::map<std::string, MatmulConfig> matmul_cache;
+    std::map<std::string, ElementwiseConfig> elementwise_cache;
+
+    Autotuner() {
+        const char* env = std::getenv("NN_TUNING_CACHE");
+        cache_path = env ? env : "nn_tuning_cache.txt";
+
+        cpu_model = "unknown";
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("model name", 0) == 0) {
+                auto colon = line.find(':');
+                if (colon != std::string::npos) cpu_model = line.substr(colon + 2);
+                break;
+            }
+        }
+        cpu_model += " (" + std::to_string(std::thread::hardware_concurrency()) + " hilos)";
+    }
+
+    static const char* op_name(MatmulOp op) {
+        switch (op) {
+            case MatmulOp::GradWeights: return "matmul_dw";
+            case MatmulOp::GradInput: return "matmul_dx";
+            default: return "matmul";
+        }
+    }
+
+    template <typename T>
+    static std::string type_name() {
+        if constexpr (std::is_same_v<T, float>) return "f32";
+        else if constexpr (std::is_same_v<T, double>) return "f64";
+        else return "t" + std::to_string(sizeof(T));
+    }
+
+    void load() {
+        if (loaded) return;
+        loaded = true;
+        std::ifstream in(cache_path);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string cpu, key, values;
+            if (!std::getline(fields, cpu, '\t') || !std::getline(fields, key, '\t') ||
+                !std::getline(fields, values) || cpu != cpu_model) {
+                continue;
+            }
+            std::istringstream v(values);
+            if (key.rfind("matmul", 0) == 0) {
+                MatmulConfig cfg;
+                if (v >> cfg.tile_k >> cfg.tile_j >> cfg.row_block >> cfg.threads) {
+                    matmul_cache[key] = cfg;
+                }
+            } else if (key.rfind("relu:", 0) == 0) {
+                ElementwiseConfig cfg;
+                if (v >> cfg.threads) {
+                    elementwise_cache[key] = cfg;
+                }
+            }
+        }
+    }
+
+    void append(const std::string& key, const std::vector<size_t>& values) {
+        std::ofstream out(cache_path, std::ios::app);
+        if (!out) return;
+        out << cpu_model << '\t' << key << '\t';
+        for (size_t i = 0; i < values.size(); ++i) {
+            out << (i ? " " : "") << values[i];
+        }
+        out << '\n';
+    }
+
+    static std::vector<size_t> thread_candidates(size_t work_items) {
+        size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
+        std::vector<size_t> result = {1};
+        for (size_t t = 2; t <= hw && t <= work_items; t *= 2) {
+            result.push_back(t);
+        }
+        if (hw <= work_items && result.back() != hw) result.push_back(hw);
+        return result;
+    }
+
+    //Mejor de 3 mediciones, tras una ejecucion de calentamiento
+    template <typename F>
+    static double time_best(F&& run) {
+        run();
+        double best = std::numeric_limits<double>::max();
+        for (int rep = 0; rep < 3; ++rep) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    template <typename T>
+    static MatmulConfig tune_matmul(MatmulOp op, size_t M, size_t K, size_t N) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        std::vector<T> x(M * K), W(K * N), g(M * N), b(N), out(M * N), dW(K * N), dx(M * K);
+        for (auto& v : x) v = static_cast<T>(dis(gen));
+        for (auto& v : W) v = static_cast<T>(dis(gen));
+        for (auto& v : g) v = static_cast<T>(dis(gen));
+
+        auto run = [&](const MatmulConfig& cfg) {
+            switch (op) {
+                case MatmulOp::Forward:
+                    matmul_bias(x.data(), W.data(), b.data(), out.data(), M, K, N, cfg);
+                    break;
+                case MatmulOp::GradWeights:
+                    matmul_grad_weights(x.data(), g.data(), dW.data(), M, K, N, cfg);
+                    break;
+                case MatmulOp::GradInput:
+                    matmul_grad_input(g.data(), W.data(), dx.data(), M, K, N, cfg);
+                    break;
+            }
+        };
+        //dW se reparte por filas de W; los otros dos por filas del lote
+        size_t work_items = op == MatmulOp::GradWeights ? K : M;
+        //GradInput no usa tiles: basta con probar uno
+        bool tiled = op != MatmulOp::GradInput;
+
+        MatmulConfig best;
+        double best_time = std::numeric_limits<double>::max();
+        for (size_t tile_k : {size_t{32}, size_t{128}}) {
+            for (size_t tile_j : {size_t{64}, size_t{256}}) {
+                //Tiles mayores que la matriz equivalen al tile completo
+                if ((tile_k > K && tile_k != 32) || (tile_j > N && tile_j != 64)) continue;
+                if (!tiled && (tile_k != 32 || tile_j != 64)) continue;
+                for (size_t row_block : {size_t{1}, size_t{2}, size_t{4}}) {
+                    if (row_block > M) continue;
+                    for (size_t threads : thread_candidates(work_items)) {
+                        MatmulConfig cfg{tile_k, tile_j, row_block, threads};
+                        double t = time_best([&] { run(cfg); });
+                        if (t < best_time) {
+                            best_time = t;
+                            best = cfg;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    template <typename T>
+    static ElementwiseConfig tune_elementwise(size_t n) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        std::vector<T> x(n), y(n), mask(n);
+        for (auto& v : x) v = static_cast<T>(dis(gen));
+
+        ElementwiseConfig best;
+        double best_time = std::numeric_limits<double>::max();
+        for (size_t threads : thread_candidates(n)) {
+            ElementwiseConfig cfg{threads};
+            double t = time_best([&] { relu_forward(x.data(), y.data(), mask.data(), n, cfg); });
+            if (t < best_time) {
+                best_time = t;
+                best = cfg;
+            }
+        }
+        return best;
+    }
+};
+
+} // namespace utec::neural_network
@@ -1,6 +1,8 @@
 #pragma once
 #include "tensor.h"
 #include "nn_layer.h"
+#include "nn_autotune.h"
+#include <stdexcept>
 
 namespace utec::neural_network {
 
@@ -26,50 +28,46 @@ public:
     }
 
     Tensor<T,2> forward(const Tensor<T,2>& x) override {
+        if (x.shape().size() != 2 || x.shape()[1] != W.shape()[0]) {
+            throw std::invalid_argument("Input width doesn't match the dense layer");
+        }
         last_x = x;
-        Tensor<T,2> output(x.shape()[0], W.shape()[1]);
+        size_t M = x.shape()[0], K = W.shape()[0], N = W.shape()[1];
+        Tensor<T,2> output(M, N);
 
-        for (size_t i = 0; i < x.shape()[0]; ++i) {
-            for (size_t j = 0; j < W.shape()[1]; ++j) {
-                output.at(i, j) = b.at(j);
-                for (size_t k = 0; k < W.shape()[0]; ++k) {
-                    output.at(i, j) += x.at(i, k) * W.at(k, j);
-                }
-            }
-        }
+        //Tiles, desenrollado e hilos elegidos por el autotuner para esta forma
+        auto cfg = Autotuner::instance().matmul<T>(M, K, N);
+        matmul_bias(x.data(), W.data(), b.data(), output.data(), M, K, N, cfg);
         return output;
     }
 
     Tensor<T,2> backward(const Tensor<T,2>& grad) override {
-        for (size_t i = 0; i < W.shape()[0]; ++i) {
-            for (size_t j = 0; j < W.shape()[1]; ++j) {
-                dW.at(i, j) = 0;
-                for (size_t k = 0; k < grad.shape()[0]; ++k) {
-                    dW.at(i, j) += last_x.at(k, i) * grad.at(k, j);
-                }
-            }
+        if (last_x.size() == 0 || grad.shape()[0] != last_x.shape()[0] || grad.shape()[1] != W.shape()[1]) {
+            throw std::invalid_argument("Gradient shape doesn't match the last dense forward");
         }
+        size_t M = grad.shape()[0], K = W.shape()[0], N = W.shape()[1];
+        auto& tuner = Autotuner::instance();
+        matmul_grad_weights(last_x.data(), grad.data(), dW.data(), M, K, N,
+                            tuner.matmul<T>(M, K, N, MatmulOp::GradWeights));
 
-        for (size_t j = 0; j < b.shape()[0]; ++j) {
-            db.at(j) = 0;
-            for (size_t k = 0; k < grad.shape()[0]; ++k) {
-                db.at(j) += grad.at(k, j);
+        T* db_data = db.data();
+        std::fill(db_data, db_data + N, T(0));
+        for (size_t i = 0; i < M; ++i) {
+            const T* g_row = grad.data() + i * N;
+            for (size_t j = 0; j < N; ++j) {
+                db_data[j] += g_row[j];
             }
         }
 
         //Gradiente respecto a la entrada
-        Tensor<T,2> input_grad(last_x.shape()[0], last_x.shape()[1]);
-        for (size_t i = 0; i < input_grad.shape()[0]; ++i) {
-            for (size_t j = 0; j < input_grad.shape()[1]; ++j) {
-                input_grad.at(i, j) = 0;
-                for (size_t k = 0; k < W.shape()[1]; ++k) {
-                    input_grad.at(i, j) += grad.at(i, k) * W.at(j, k);
-                }
-            }
-        }
-
+        Tensor<T,2> input_grad(M, K);
+        matmul_grad_input(grad.data(), W.data(), input_grad.data(), M, K, N,
+                          tuner.matmul<T>(M, K, N, MatmulOp::GradInput));
         return input_grad;
     }
+
+    size_t cache_bytes() const override { return last_x.size() * sizeof(T); }
+    void release_cache() override { last_x = Tensor<T,2>(); }
 };
 
 } // namespace utec::neural_network
\ No newline at end of file
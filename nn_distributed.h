@@ -0,0 +1,521 @@
+#pragma once
+#include "tensor.h"
+#include "neural_network.h"
+#include "nn_optimizer.h"
+#include "nn_autotune.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace utec::neural_network {
+
+//Transporte del anillo: cada rank envia al siguiente y recibe del anterior.
+//exchange hace ambas cosas por piezas intercaladas para que ningun rank quede
+//bloqueado enviando mientras su vecino tambien envia.
+class IRingTransport {
+public:
+    virtual ~IRingTransport() = default;
+    virtual void exchange(const void* send, size_t send_bytes, void* recv, size_t recv_bytes) = 0;
+};
+
+//Buzones en memoria compartida POSIX, uno por rank. El anillo se crea antes
+//de fork para que todos los procesos hereden el mismo mapeo. Un bloque de
+//control al inicio guarda la bandera de aborto: el rank que falla la marca
+//y los que esperan en el anillo la ven y abandonan en vez de girar para siempre.
+class ShmRing {
+public:
+    static constexpr size_t kSlotBytes = 64 * 1024;
+
+    struct Mailbox {
+        std::atomic<uint64_t> written;
+        std::atomic<uint64_t> read;
+        char data[kSlotBytes];
+    };
+
+    struct alignas(64) Control {
+        std::atomic<uint32_t> aborted;
+    };
+
+    explicit ShmRing(size_t world) : world_(world) {
+        static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                      "Shared-memory mailboxes need lock-free atomics");
+        std::string name = "/nn_ring_" + std::to_string(getpid());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::runtime_error("shm_open failed for " + name);
+        }
+        bytes_ = sizeof(Control) + world * sizeof(Mailbox);
+        if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("ftruncate failed for " + name);
+        }
+        void* addr = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        //El nombre ya no hace falta: el mapeo sobrevive y se hereda con fork
+        shm_unlink(name.c_str());
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("mmap failed for " + name);
+        }
+        control_ = static_cast<Control*>(addr);
+        new (&control_->aborted) std::atomic<uint32_t>(0);
+        mailboxes_ = reinterpret_cast<Mailbox*>(static_cast<char*>(addr) + sizeof(Control));
+        for (size_t r = 0; r < world; ++r) {
+            new (&mailboxes_[r].written) std::atomic<uint64_t>(0);
+            new (&mailboxes_[r].read) std::atomic<uint64_t>(0);
+        }
+    }
+
+    ~ShmRing() { munmap(control_, bytes_); }
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    Mailbox& mailbox(size_t rank) { return mailboxes_[rank]; }
+    size_t world() const { return world_; }
+
+    void abort() { control_->aborted.store(1, std::memory_order_release); }
+    bool aborted() const { return control_->aborted.load(std::memory_order_acquire) != 0; }
+
+private:
+    size_t world_;
+    size_t bytes_;
+    Control* control_;
+    Mailbox* mailboxes_;
+};
+
+//Las esperas terminan con excepcion si otro rank aborto el anillo o si el
+//vecino no avanza en `timeout` (un rank que muere por senal no alcanza a
+//marcar la bandera).
+class ShmRingTransport : public IRingTransport {
+    ShmRing& ring;
+    size_t rank;
+    std::chrono::milliseconds timeout;
+
+    void wait_until(const std::atomic<uint64_t>& value, uint64_t expected) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (size_t spins = 0; value.load(std::memory_order_acquire) != expected; ++spins) {
+            if (spins <= 64) continue;
+            std::this_thread::yield();
+            if (ring.aborted()) {
+                throw std::runtime_error("Ring aborted by another rank");
+            }
+            if (spins % 1024 == 0 && std::chrono::steady_clock::now() > deadline) {
+                ring.abort();
+                throw std::runtime_error("Timed out waiting for a neighbour rank");
+            }
+        }
+    }
+
+public:
+    ShmRingTransport(ShmRing& ring, size_t rank,
+                     std::chrono::milliseconds timeout = std::chrono::seconds(60))
+        : ring(ring), rank(rank), timeout(timeout) {}
+
+    void exchange(const void* send, size_t send_bytes, void* recv, size_t recv_bytes) override {
+        auto& out = ring.mailbox((rank + 1) % ring.world());
+        auto& in = ring.mailbox(rank);
+        auto src = static_cast<const char*>(send);
+        auto dst = static_cast<char*>(recv);
+
+        for (size_t offset = 0; offset < send_bytes || offset < recv_bytes; offset += ShmRing::kSlotBytes) {
+            if (offset < send_bytes) {
+                //El slot esta libre cuando el vecino ya leyo la pieza anterior
+                uint64_t seq = out.written.load(std::memory_order_relaxed);
+                wait_until(out.read, seq);
+                std::memcpy(out.data, src + offset, std::min(ShmRing::kSlotBytes, send_bytes - offset));
+                out.written.store(seq + 1, std::memory_order_release);
+            }
+            if (offset < recv_bytes) {
+                uint64_t seq = in.read.load(std::memory_order_relaxed);
+                wait_until(in.written, seq + 1);
+                std::memcpy(dst + offset, in.data, std::min(ShmRing::kSlotBytes, recv_bytes - offset));
+                in.read.store(seq + 1, std::memory_order_release);
+            }
+        }
+    }
+};
+
+//Sockets TCP por loopback. Los listeners se abren antes de fork (puerto 0,
+//el kernel elige), asi cada rank sabe a que puerto conectarse sin carreras.
+//El mismo protocolo sirve entre hosts cambiando la direccion.
+class TcpRing {
+public:
+    explicit TcpRing(size_t world) {
+        for (size_t r = 0; r < world; ++r) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd < 0) throw std::runtime_error("socket failed");
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0;
+            socklen_t len = sizeof(addr);
+            if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                listen(fd, 1) != 0 ||
+                getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+                close(fd);
+                throw std::runtime_error("Could not open loopback listener");
+            }
+            listeners.push_back(fd);
+            ports.push_back(ntohs(addr.sin_port));
+        }
+    }
+
+    ~TcpRing() {
+        for (int fd : listeners) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    TcpRing(const TcpRing&) = delete;
+    TcpRing& operator=(const TcpRing&) = delete;
+
+    std::vector<int> listeners;
+    std::vector<uint16_t> ports;
+};
+
+class TcpRingTransport : public IRingTransport {
+    static constexpr size_t kPieceBytes = 16 * 1024;
+    int next_fd = -1;
+    int prev_fd = -1;
+
+    static void send_all(int fd, const char* buf, size_t n) {
+        while (n > 0) {
+            ssize_t sent = ::send(fd, buf, n, MSG_NOSIGNAL);
+            if (sent <= 0) throw std::runtime_error("Ring send failed");
+            buf += sent;
+            n -= static_cast<size_t>(sent);
+        }
+    }
+
+    static void recv_all(int fd, char* buf, size_t n) {
+        while (n > 0) {
+            ssize_t got = ::recv(fd, buf, n, 0);
+            if (got <= 0) throw std::runtime_error("Ring recv failed");
+            buf += got;
+            n -= static_cast<size_t>(got);
+        }
+    }
+
+public:
+    TcpRingTransport(TcpRing& ring, size_t rank) {
+        size_t world = ring.ports.size();
+        next_fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(ring.ports[(rank + 1) % world]);
+        if (next_fd < 0 || connect(next_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            throw std::runtime_error("Could not connect to next rank");
+        }
+        prev_fd = accept(ring.listeners[rank], nullptr, nullptr);
+        if (prev_fd < 0) {
+            throw std::runtime_error("Could not accept previous rank");
+        }
+        int one = 1;
+        setsockopt(next_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(prev_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    ~TcpRingTransport() override {
+        if (next_fd >= 0) close(next_fd);
+        if (prev_fd >= 0) close(prev_fd);
+    }
+
+    void exchange(const void* send, size_t send_bytes, void* recv, size_t recv_bytes) override {
+        auto src = static_cast<const char*>(send);
+        auto dst = static_cast<char*>(recv);
+        for (size_t offset = 0; offset < send_bytes || offset < recv_bytes; offset += kPieceBytes) {
+            if (offset < send_bytes) {
+                send_all(next_fd, src + offset, std::min(kPieceBytes, send_bytes - offset));
+            }
+            if (offset < recv_bytes) {
+                recv_all(prev_fd, dst + offset, std::min(kPieceBytes, recv_bytes - offset));
+            }
+        }
+    }
+};
+
+//All-reduce en anillo: reduce-scatter seguido de all-gather, 2*(N-1) pasos
+//donde cada rank mueve 1/N del buffer por paso.
+template <typename T>
+class RingAllReduce {
+    IRingTransport& transport;
+    size_t rank, world;
+    std::vector<T> recv_buf;
+
+public:
+    RingAllReduce(IRingTransport& transport, size_t rank, size_t world)
+        : transport(transport), rank(rank), world(world) {}
+
+    void sum(T* data, size_t count) {
+        if (world == 1) return;
+        auto chunk_begin = [&](size_t c) { return c * count / world; };
+        auto chunk_size = [&](size_t c) { return chunk_begin(c + 1) - chunk_begin(c); };
+        recv_buf.resize(chunk_size(0) + 1);
+
+        for (size_t step = 0; step + 1 < world; ++step) {
+            size_t send_c = (rank + world - step) % world;
+            size_t recv_c = (rank + world - step - 1) % world;
+            transport.exchange(data + chunk_begin(send_c), chunk_size(send_c) * sizeof(T),
+                               recv_buf.data(), chunk_size(recv_c) * sizeof(T));
+            T* target = data + chunk_begin(recv_c);
+            for (size_t i = 0; i < chunk_size(recv_c); ++i) {
+                target[i] += recv_buf[i];
+            }
+        }
+
+        for (size_t step = 0; step + 1 < world; ++step) {
+            size_t send_c = (rank + 1 + world - step) % world;
+            size_t recv_c = (rank + world - step) % world;
+            transport.exchange(data + chunk_begin(send_c), chunk_size(send_c) * sizeof(T),
+                               data + chunk_begin(recv_c), chunk_size(recv_c) * sizeof(T));
+        }
+    }
+
+    void average(T* data, size_t count) {
+        sum(data, count);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] /= static_cast<T>(world);
+        }
+    }
+};
+
+//Promedia dW/db entre ranks en un hilo de comunicacion: backward sigue con
+//las capas anteriores mientras se reducen las que ya terminaron.
+template <typename T>
+class RingGradientReducer : public IGradientReducer<T> {
+    RingAllReduce<T>& collective;
+    std::deque<std::pair<Tensor<T,2>*, Tensor<T,1>*>> pending;
+    size_t in_flight = 0;
+    bool stopping = false;
+    std::mutex mtx;
+    std::condition_variable work_cv, done_cv;
+    std::vector<T> flat;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            work_cv.wait(lock, [&] { return stopping || !pending.empty(); });
+            if (pending.empty()) return;
+            auto [dW, db] = pending.front();
+            pending.pop_front();
+            lock.unlock();
+
+            //dW y db viajan juntos en un solo all-reduce
+            flat.resize(dW->size() + db->size());
+            std::copy(dW->data(), dW->data() + dW->size(), flat.begin());
+            std::copy(db->data(), db->data() + db->size(), flat.begin() + dW->size());
+            collective.average(flat.data(), flat.size());
+            std::copy(flat.begin(), flat.begin() + dW->size(), dW->data());
+            std::copy(flat.begin() + dW->size(), flat.end(), db->data());
+
+            lock.lock();
+            --in_flight;
+            done_cv.notify_all();
+        }
+    }
+
+public:
+    explicit RingGradientReducer(RingAllReduce<T>& collective)
+        : collective(collective), worker([this] { run(); }) {}
+
+    ~RingGradientReducer() override {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        work_cv.notify_all();
+        worker.join();
+    }
+
+    void on_gradient_ready(Tensor<T,2>& dW, Tensor<T,1>& db) override {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            pending.emplace_back(&dW, &db);
+            ++in_flight;
+        }
+        work_cv.notify_one();
+    }
+
+    void synchronize() override {
+        std::unique_lock<std::mutex> lock(mtx);
+        done_cv.wait(lock, [&] { return in_flight == 0; });
+    }
+};
+
+enum class RingTransportKind { SharedMemory, Tcp };
+
+//Entrenamiento data-parallel con N procesos locales. Este proceso es el
+//rank 0 y los demas se crean con fork, asi que todos parten de los mismos
+//pesos y estado del optimizador. Cada rank entrena sobre su fragmento de X
+//con lotes de `batch_size` y los gradientes se promedian con all-reduce,
+//equivalente a un lote global de batch_size * workers. Los fragmentos
+//difieren a lo sumo en una muestra, y todos los ranks dan el mismo numero
+//de pasos (un paso por all-reduce).
+template <typename T>
+class DataParallelTrainer {
+    size_t workers;
+    RingTransportKind kind;
+
+    //Los lotes se cuentan sobre el fragmento mayor y se reparten parejo en
+    //cada fragmento; sin pasar del menor para que ningun lote quede vacio
+    static size_t batches_per_rank(size_t samples, size_t world, size_t batch_size) {
+        size_t max_shard = (samples + world - 1) / world;
+        return std::min((max_shard + batch_size - 1) / batch_size, samples / world);
+    }
+
+    //Mide en este proceso los kernels de cada forma de lote que usaran los
+    //ranks, asi los hijos heredan la cache ya resuelta en vez de medir todos a
+    //la vez (y escribir el archivo cada uno)
+    static void pretune(NeuralNetwork<T>& nn, size_t samples, size_t world, size_t features, size_t batch_size) {
+        size_t num_batches = batches_per_rank(samples, world, batch_size);
+        size_t smallest = samples / world / num_batches;
+        size_t largest = ((samples + world - 1) / world + num_batches - 1) / num_batches;
+        for (size_t rows : {smallest, largest}) {
+            Tensor<T,2> probe(rows, features);
+            Tensor<T,2> output = nn.forward(probe);
+            nn.backward(output);
+        }
+    }
+
+    static void run_worker(NeuralNetwork<T>& nn, IRingTransport& transport, size_t rank, size_t world,
+                           const Tensor<T,2>& X, const Tensor<T,2>& Y, size_t epochs, size_t batch_size) {
+        RingAllReduce<T> collective(transport, rank, world);
+        RingAllReduce<T> gradients(transport, rank, world);
+        nn.set_gradient_reducer(std::make_unique<RingGradientReducer<T>>(gradients));
+        try {
+            train_shard(nn, collective, rank, world, X, Y, epochs, batch_size);
+        } catch (...) {
+            nn.set_gradient_reducer(nullptr);
+            throw;
+        }
+        nn.set_gradient_reducer(nullptr);
+    }
+
+    static void train_shard(NeuralNetwork<T>& nn, RingAllReduce<T>& collective, size_t rank, size_t world,
+                            const Tensor<T,2>& X, const Tensor<T,2>& Y, size_t epochs, size_t batch_size) {
+        size_t samples = X.shape()[0];
+        size_t shard_start = rank * samples / world;
+        size_t shard = (rank + 1) * samples / world - shard_start;
+        size_t num_batches = batches_per_rank(samples, world, batch_size);
+
+        for (size_t epoch = 0; epoch < epochs; ++epoch) {
+            T total_loss = 0;
+            for (size_t batch = 0; batch < num_batches; ++batch) {
+                size_t start = shard_start + batch * shard / num_batches;
+                size_t end = shard_start + (batch + 1) * shard / num_batches;
+                total_loss += nn.train_step(X.slice(start, end), Y.slice(start, end));
+            }
+            nn.apply_pruning_schedule(epoch);
+
+            T loss = total_loss / num_batches;
+            collective.average(&loss, 1);
+            if (rank == 0) {
+                std::cout << "Epoch " << epoch + 1 << "/" << epochs
+                          << ", Loss: " << loss << "\n";
+            }
+        }
+    }
+
+public:
+    explicit DataParallelTrainer(size_t workers, RingTransportKind kind = RingTransportKind::SharedMemory)
+        : workers(workers), kind(kind) {
+        if (workers == 0) {
+            throw std::invalid_argument("DataParallelTrainer needs at least one worker");
+        }
+    }
+
+    void train(NeuralNetwork<T>& nn, const Tensor<T,2>& X, const Tensor<T,2>& Y,
+               size_t epochs, size_t batch_size = 32) {
+        if (X.shape()[0] < workers) {
+            throw std::invalid_argument("Not enough samples for the number of workers");
+        }
+        std::unique_ptr<ShmRing> shm;
+        std::unique_ptr<TcpRing> tcp;
+        if (kind == RingTransportKind::SharedMemory) {
+            shm = std::make_unique<ShmRing>(workers);
+        } else {
+            tcp = std::make_unique<TcpRing>(workers);
+        }
+
+        auto make_transport = [&](size_t rank) -> std::unique_ptr<IRingTransport> {
+            if (shm) return std::make_unique<ShmRingTransport>(*shm, rank);
+            return std::make_unique<TcpRingTransport>(*tcp, rank);
+        };
+
+        pretune(nn, X.shape()[0], workers, X.shape()[1], batch_size);
+
+        //Evita que los hijos hereden salida pendiente y la dupliquen
+        std::cout.flush();
+        std::vector<pid_t> children;
+        for (size_t rank = 1; rank < workers; ++rank) {
+            pid_t pid = fork();
+            if (pid < 0) {
+                throw std::runtime_error("fork failed");
+            }
+            if (pid == 0) {
+                //Solo el rank 0 mide formas nuevas y escribe la cache
+                Autotuner::instance().set_frozen(true);
+                int status = 0;
+                try {
+                    auto transport = make_transport(rank);
+                    run_worker(nn, *transport, rank, workers, X, Y, epochs, batch_size);
+                } catch (const std::exception& e) {
+                    std::cerr << "Worker " << rank << ": " << e.what() << "\n";
+                    status = 1;
+                }
+                if (status != 0 && shm) shm->abort();
+                std::cout.flush();
+                _exit(status);
+            }
+            children.push_back(pid);
+        }
+
+        try {
+            auto transport = make_transport(0);
+            run_worker(nn, *transport, 0, workers, X, Y, epochs, batch_size);
+        } catch (...) {
+            //Sin el rank 0 el anillo no avanza: se detiene a los demas
+            if (shm) shm->abort();
+            for (pid_t pid : children) {
+                kill(pid, SIGTERM);
+                waitpid(pid, nullptr, 0);
+            }
+            throw;
+        }
+
+        bool failed = false;
+        for (pid_t pid : children) {
+            int status = 0;
+            waitpid(pid, &status, 0);
+            failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        }
+        if (failed) {
+            throw std::runtime_error("A data-parallel worker failed");
+        }
+    }
+};
+
+} // namespace utec::neural_network
@@ -0,0 +1,342 @@
+#pragma once
+#include "tensor.h"
+#include "nn_layer.h"
+#include "nn_dense.h"
+#include "nn_loss.h"
+#include "nn_optimizer.h"
+#include "nn_task_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace utec::neural_network {
+
+using NodeId = size_t;
+
+//Modelo como grafo dirigido aciclico: los nodos son entradas, capas o
+//uniones (suma / concatenacion por columnas) y las aristas se dan al crear
+//cada nodo. forward y backward ejecutan en paralelo los nodos listos sobre
+//un WorkStealingPool; cada nodo se lanza cuando terminan sus dependencias.
+template <typename T>
+class GraphModel {
+    enum class NodeKind { Input, Layer, Add, Concat };
+
+    struct Node {
+        NodeKind kind;
+        std::unique_ptr<ILayer<T>> layer;
+        std::vector<NodeId> inputs;
+        std::vector<NodeId> consumers;   //una entrada por cada arista
+        size_t input_slot = 0;
+        bool live = false;               //contribuye a la salida
+
+        Tensor<T,2> output;
+        std::vector<size_t> input_widths;
+        std::atomic<size_t> remaining{0};
+        std::atomic<size_t> pending_reads{0};
+
+        std::mutex grad_mtx;
+        Tensor<T,2> grad;
+        bool has_grad = false;
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<NodeId> input_nodes;
+    NodeId output_node = 0;
+    bool has_output = false;
+    WorkStealingPool pool;
+    MSELoss<T> criterion;
+
+    NodeId add_node(NodeKind kind, std::vector<NodeId> inputs) {
+        for (NodeId in : inputs) {
+            if (in >= nodes.size()) {
+                throw std::invalid_argument("Graph edge refers to an unknown node");
+            }
+        }
+        NodeId id = nodes.size();
+        auto node = std::make_unique<Node>();
+        node->kind = kind;
+        node->inputs = std::move(inputs);
+        for (NodeId in : node->inputs) {
+            nodes[in]->consumers.push_back(id);
+        }
+        nodes.push_back(std::move(node));
+        return id;
+    }
+
+    //Marca los nodos de los que depende la salida
+    void mark_live() {
+        for (auto& node : nodes) node->live = false;
+        std::vector<NodeId> stack = {output_node};
+        while (!stack.empty()) {
+            Node& node = *nodes[stack.back()];
+            stack.pop_back();
+            if (node.live) continue;
+            node.live = true;
+            for (NodeId in : node.inputs) stack.push_back(in);
+        }
+    }
+
+    //Solo se lanzan consumidores vivos; los muertos no se ejecutan
+    void finish_forward(NodeId id) {
+        for (NodeId consumer : nodes[id]->consumers) {
+            if (!nodes[consumer]->live) continue;
+            if (nodes[consumer]->remaining.fetch_sub(1) == 1) {
+                pool.submit([this, consumer] { run_forward(consumer); });
+            }
+        }
+    }
+
+    //Libera la salida de un nodo cuando todos sus consumidores ya la leyeron
+    void release_input(NodeId id) {
+        if (nodes[id]->pending_reads.fetch_sub(1) == 1 && id != output_node) {
+            nodes[id]->output = Tensor<T,2>();
+        }
+    }
+
+    void run_forward(NodeId id) {
+        Node& node = *nodes[id];
+        switch (node.kind) {
+            case NodeKind::Input:
+                break;
+            case NodeKind::Layer:
+                node.output = node.layer->forward(nodes[node.inputs[0]]->output);
+                break;
+            case NodeKind::Add: {
+                node.output = nodes[node.inputs[0]]->output;
+                for (size_t i = 1; i < node.inputs.size(); ++i) {
+                    const auto& other = nodes[node.inputs[i]]->output;
+                    if (other.shape() != node.output.shape()) {
+                        throw std::invalid_argument("Add node inputs must have the same shape");
+                    }
+                    for (size_t k = 0; k < other.size(); ++k) {
+                        node.output.data()[k] += other.data()[k];
+                    }
+                }
+                break;
+            }
+            case NodeKind::Concat: {
+                size_t rows = nodes[node.inputs[0]]->output.shape()[0];
+                size_t cols = 0;
+                node.input_widths.clear();
+                for (NodeId in : node.inputs) {
+                    const auto& part = nodes[in]->output;
+                    if (part.shape()[0] != rows) {
+                        throw std::invalid_argument("Concat node inputs must have the same rows");
+                    }
+                    node.input_widths.push_back(part.shape()[1]);
+                    cols += part.shape()[1];
+                }
+                node.output = Tensor<T,2>(rows, cols);
+                size_t offset = 0;
+                for (size_t i = 0; i < node.inputs.size(); ++i) {
+                    const auto& part = nodes[node.inputs[i]]->output;
+                    size_t width = node.input_widths[i];
+                    for (size_t r = 0; r < rows; ++r) {
+                        std::copy(part.data() + r * width, part.data() + (r + 1) * width,
+                                  node.output.data() + r * cols + offset);
+                    }
+                    offset += width;
+                }
+                break;
+            }
+        }
+        for (NodeId in : node.inputs) {
+            release_input(in);
+        }
+        finish_forward(id);
+    }
+
+    void accumulate_grad(NodeId id, Tensor<T,2> g) {
+        Node& node = *nodes[id];
+        {
+            std::lock_guard<std::mutex> lock(node.grad_mtx);
+            if (!node.has_grad) {
+                node.grad = std::move(g);
+                node.has_grad = true;
+            } else {
+                for (size_t k = 0; k < g.size(); ++k) {
+                    node.grad.data()[k] += g.data()[k];
+                }
+            }
+        }
+        if (node.remaining.fetch_sub(1) == 1) {
+            pool.submit([this, id] { run_backward(id); });
+        }
+    }
+
+    void run_backward(NodeId id) {
+        Node& node = *nodes[id];
+        //El gradiente acumulado se libera en cuanto este nodo lo consume
+        Tensor<T,2> g = std::move(node.grad);
+        node.grad = Tensor<T,2>();
+        node.has_grad = false;
+
+        switch (node.kind) {
+            case NodeKind::Input:
+                return;
+            case NodeKind::Layer: {
+                Tensor<T,2> input_grad = node.layer->backward(g);
+                node.layer->release_cache();
+                g = Tensor<T,2>();
+                accumulate_grad(node.inputs[0], std::move(input_grad));
+                return;
+            }
+            case NodeKind::Add:
+                for (NodeId in : node.inputs) {
+                    accumulate_grad(in, g);
+                }
+                return;
+            case NodeKind::Concat: {
+                size_t rows = g.shape()[0];
+                size_t cols = g.shape()[1];
+                size_t offset = 0;
+                for (size_t i = 0; i < node.inputs.size(); ++i) {
+                    size_t width = node.input_widths[i];
+                    Tensor<T,2> part(rows, width);
+                    for (size_t r = 0; r < rows; ++r) {
+                        std::copy(g.data() + r * cols + offset, g.data() + r * cols + offset + width,
+                                  part.data() + r * width);
+                    }
+                    offset += width;
+                    accumulate_grad(node.inputs[i], std::move(part));
+                }
+                return;
+            }
+        }
+    }
+
+public:
+    std::unique_ptr<IOptimizer<T>> optimizer;
+
+    //threads = 0 usa todos los nucleos
+    explicit GraphModel(size_t threads = 0) : pool(threads) {}
+
+    NodeId add_input() {
+        NodeId id = add_node(NodeKind::Input, {});
+        nodes[id]->input_slot = input_nodes.size();
+        input_nodes.push_back(id);
+        return id;
+    }
+
+    NodeId add_layer(std::unique_ptr<ILayer<T>> layer, NodeId input) {
+        NodeId id = add_node(NodeKind::Layer, {input});
+        nodes[id]->layer = std::move(layer);
+        return id;
+    }
+
+    NodeId add_add(std::vector<NodeId> inputs) {
+        if (inputs.empty()) throw std::invalid_argument("Add node needs at least one input");
+        return add_node(NodeKind::Add, std::move(inputs));
+    }
+
+    NodeId add_concat(std::vector<NodeId> inputs) {
+        if (inputs.empty()) throw std::invalid_argument("Concat node needs at least one input");
+        return add_node(NodeKind::Concat, std::move(inputs));
+    }
+
+    void set_output(NodeId id) {
+        if (id >= nodes.size()) throw std::invalid_argument("Unknown output node");
+        output_node = id;
+        has_output = true;
+    }
+
+    void set_optimizer(std::unique_ptr<IOptimizer<T>> opt) {
+        optimizer = std::move(opt);
+    }
+
+    Tensor<T,2> forward(const std::vector<Tensor<T,2>>& inputs) {
+        if (!has_output) throw std::logic_error("GraphModel has no output node");
+        if (inputs.size() != input_nodes.size()) {
+            throw std::invalid_argument("Expected one tensor per graph input");
+        }
+        mark_live();
+        for (auto& node : nodes) {
+            if (!node->live) {
+                //Un nodo muerto no corre; suelta lo que haya quedado de pasadas anteriores
+                node->output = Tensor<T,2>();
+                if (node->layer) node->layer->release_cache();
+                continue;
+            }
+            size_t live_consumers = 0;
+            for (NodeId consumer : node->consumers) {
+                if (nodes[consumer]->live) ++live_consumers;
+            }
+            node->remaining = node->inputs.size();
+            node->pending_reads = live_consumers;
+        }
+        //Los nodos de entrada ya estan listos; los demas se lanzan al cumplir dependencias
+        for (NodeId id : input_nodes) {
+            if (nodes[id]->live) nodes[id]->output = inputs[nodes[id]->input_slot];
+        }
+        for (NodeId id : input_nodes) {
+            if (nodes[id]->live) finish_forward(id);
+        }
+        pool.wait();
+
+        Tensor<T,2> output = std::move(nodes[output_node]->output);
+        nodes[output_node]->output = Tensor<T,2>();
+        return output;
+    }
+
+    //Para grafos con una sola entrada
+    Tensor<T,2> forward(const Tensor<T,2>& x) {
+        return forward(std::vector<Tensor<T,2>>{x});
+    }
+
+    void backward(const Tensor<T,2>& grad) {
+        //Un nodo esta listo cuando le llego el gradiente de todos sus consumidores vivos
+        for (auto& node : nodes) {
+            size_t live_consumers = 0;
+            for (NodeId consumer : node->consumers) {
+                if (nodes[consumer]->live) ++live_consumers;
+            }
+            node->remaining = live_consumers;
+            node->has_grad = false;
+        }
+        nodes[output_node]->remaining = 1;
+        pool.submit([this, g = grad] { accumulate_grad(output_node, g); });
+        pool.wait();
+    }
+
+    void optimize() {
+        for (auto& node : nodes) {
+            if (auto dense = dynamic_cast<Dense<T>*>(node->layer.get()); dense && node->live) {
+                optimizer->update(dense->W, dense->dW);
+                optimizer->update(dense->b, dense->db);
+            }
+        }
+    }
+
+    T train_step(const std::vector<Tensor<T,2>>& inputs, const Tensor<T,2>& y) {
+        Tensor<T,2> output = forward(inputs);
+        T loss = criterion.forward(output, y);
+        backward(criterion.backward());
+        optimize();
+        return loss;
+    }
+
+    void train(const std::vector<Tensor<T,2>>& X, const Tensor<T,2>& Y, size_t epochs, size_t batch_size = 32) {
+        size_t samples = Y.shape()[0];
+        size_t num_batches = (samples + batch_size - 1) / batch_size;
+        for (size_t epoch = 0; epoch < epochs; ++epoch) {
+            T total_loss = 0;
+            for (size_t batch = 0; batch < num_batches; ++batch) {
+                size_t start = batch * batch_size;
+                size_t end = std::min(start + batch_size, samples);
+                std::vector<Tensor<T,2>> x_batch;
+                for (const auto& x : X) {
+                    x_batch.push_back(x.slice(start, end));
+                }
+                total_loss += train_step(x_batch, Y.slice(start, end));
+            }
+            std::cout << "Epoch " << epoch + 1 << "/" << epochs
+                      << ", Loss: " << total_loss / num_batches << "\n";
+        }
+    }
+};
+
+} // namespace utec::neural_network
@@ -0,0 +1,349 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace utec::neural_network {
+
+//Productos de una capa densa (x: M x K, W: K x N, g: M x N, row-major):
+//Forward out = x * W + b, GradWeights dW = x^T * g, GradInput dx = g * W^T
+enum class MatmulOp { Forward, GradWeights, GradInput };
+
+//Parametros de los kernels de producto
+struct MatmulConfig {
+    size_t tile_k = 64;
+    size_t tile_j = 256;
+    size_t row_block = 1;   //filas de x procesadas juntas (desenrollado)
+    size_t threads = 1;
+
+    bool operator==(const MatmulConfig&) const = default;
+};
+
+//Parametros de los kernels elemento a elemento (ReLU)
+struct ElementwiseConfig {
+    size_t threads = 1;
+
+    bool operator==(const ElementwiseConfig&) const = default;
+};
+
+//Reparte [0, n) en `threads` rangos; el hilo actual ejecuta el primero
+template <typename F>
+void parallel_ranges(size_t n, size_t threads, F&& body) {
+    threads = std::max<size_t>(1, std::min(threads, n));
+    if (threads == 1) {
+        body(size_t{0}, n);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back([&, t] { body(t * n / threads, (t + 1) * n / threads); });
+    }
+    body(size_t{0}, n / threads);
+    for (auto& worker : pool) {
+        worker.join();
+    }
+}
+
+template <typename T, size_t RB>
+void matmul_rows(const T* x, const T* W, T* out, size_t r0, size_t r1,
+                 size_t K, size_t N, const MatmulConfig& cfg) {
+    for (size_t i = r0; i < r1; i += RB) {
+        for (size_t kk = 0; kk < K; kk += cfg.tile_k) {
+            size_t k_end = std::min(kk + cfg.tile_k, K);
+            for (size_t jj = 0; jj < N; jj += cfg.tile_j) {
+                size_t j_end = std::min(jj + cfg.tile_j, N);
+                for (size_t k = kk; k < k_end; ++k) {
+                    const T* w_row = W + k * N;
+                    T xv[RB];
+                    for (size_t r = 0; r < RB; ++r) {
+                        xv[r] = x[(i + r) * K + k];
+                    }
+                    for (size_t r = 0; r < RB; ++r) {
+                        T* o_row = out + (i + r) * N;
+                        for (size_t j = jj; j < j_end; ++j) {
+                            o_row[j] += xv[r] * w_row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void matmul_bias(const T* x, const T* W, const T* b, T* out,
+                 size_t M, size_t K, size_t N, const MatmulConfig& cfg) {
+    parallel_ranges(M, cfg.threads, [&](size_t r0, size_t r1) {
+        for (size_t i = r0; i < r1; ++i) {
+            std::copy(b, b + N, out + i * N);
+        }
+        size_t full = r0 + (r1 - r0) / cfg.row_block * cfg.row_block;
+        switch (cfg.row_block) {
+            case 4: matmul_rows<T, 4>(x, W, out, r0, full, K, N, cfg); break;
+            case 2: matmul_rows<T, 2>(x, W, out, r0, full, K, N, cfg); break;
+            default: full = r0; break;
+        }
+        matmul_rows<T, 1>(x, W, out, full, r1, K, N, cfg);
+    });
+}
+
+//Cada hilo llena sus filas [k0, k1) de dW; dentro de un tile de dW se
+//recorren todas las muestras, de RB en RB, en orden ascendente
+template <typename T, size_t RB>
+void grad_weights_rows(const T* x, const T* g, T* dW, size_t k0, size_t k1, size_t i0, size_t i1,
+                       size_t K, size_t N, const MatmulConfig& cfg) {
+    for (size_t kk = k0; kk < k1; kk += cfg.tile_k) {
+        size_t k_end = std::min(kk + cfg.tile_k, k1);
+        for (size_t jj = 0; jj < N; jj += cfg.tile_j) {
+            size_t j_end = std::min(jj + cfg.tile_j, N);
+            for (size_t i = i0; i < i1; i += RB) {
+                for (size_t k = kk; k < k_end; ++k) {
+                    T* dw_row = dW + k * N;
+                    for (size_t r = 0; r < RB; ++r) {
+                        T xv = x[(i + r) * K + k];
+                        const T* g_row = g + (i + r) * N;
+                        for (size_t j = jj; j < j_end; ++j) {
+                            dw_row[j] += xv * g_row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void matmul_grad_weights(const T* x, const T* g, T* dW,
+                         size_t M, size_t K, size_t N, const MatmulConfig& cfg) {
+    parallel_ranges(K, cfg.threads, [&](size_t k0, size_t k1) {
+        std::fill(dW + k0 * N, dW + k1 * N, T(0));
+        size_t full = M / cfg.row_block * cfg.row_block;
+        switch (cfg.row_block) {
+            case 4: grad_weights_rows<T, 4>(x, g, dW, k0, k1, 0, full, K, N, cfg); break;
+            case 2: grad_weights_rows<T, 2>(x, g, dW, k0, k1, 0, full, K, N, cfg); break;
+            default: full = 0; break;
+        }
+        grad_weights_rows<T, 1>(x, g, dW, k0, k1, full, M, K, N, cfg);
+    });
+}
+
+//RB filas de g comparten cada fila de W leida
+template <typename T, size_t RB>
+void grad_input_rows(const T* g, const T* W, T* dx, size_t r0, size_t r1,
+                     size_t K, size_t N) {
+    for (size_t i = r0; i < r1; i += RB) {
+        for (size_t k = 0; k < K; ++k) {
+            const T* w_row = W + k * N;
+            T acc[RB] = {};
+            for (size_t r = 0; r < RB; ++r) {
+                const T* g_row = g + (i + r) * N;
+                for (size_t j = 0; j < N; ++j) {
+                    acc[r] += g_row[j] * w_row[j];
+                }
+            }
+            for (size_t r = 0; r < RB; ++r) {
+                dx[(i + r) * K + k] = acc[r];
+            }
+        }
+    }
+}
+
+//Solo usa row_block y threads: los tiles no cambian este recorrido
+template <typename T>
+void matmul_grad_input(const T* g, const T* W, T* dx,
+                       size_t M, size_t K, size_t N, const MatmulConfig& cfg) {
+    parallel_ranges(M, cfg.threads, [&](size_t r0, size_t r1) {
+        size_t full = r0 + (r1 - r0) / cfg.row_block * cfg.row_block;
+        switch (cfg.row_block) {
+            case 4: grad_input_rows<T, 4>(g, W, dx, r0, full, K, N); break;
+            case 2: grad_input_rows<T, 2>(g, W, dx, r0, full, K, N); break;
+            default: full = r0; break;
+        }
+        grad_input_rows<T, 1>(g, W, dx, full, r1, K, N);
+    });
+}
+
+//Productos agrupados: G capas independientes con la misma forma, apiladas
+//por columnas. x: M x (G*K), W: K x (G*N), g/out: M x (G*N); el grupo q usa
+//las columnas [q*K, (q+1)*K) de x y [q*N, (q+1)*N) de W. Los acumuladores
+//cubren kLanes columnas de RB filas, asi cada tramo de W leido sirve a RB
+//filas y la salida se escribe una sola vez. La suma sigue en orden de k.
+constexpr size_t kLanes = 8;
+
+template <typename T, size_t RB>
+void grouped_matmul_rows(const T* x, const T* W, T* out, size_t r0, size_t r1,
+                         size_t K, size_t N, size_t G) {
+    size_t GK = G * K, GN = G * N;
+    for (size_t i = r0; i < r1; i += RB) {
+        for (size_t q = 0; q < G; ++q) {
+            const T* xq = x + i * GK + q * K;
+            const T* wq = W + q * N;
+            T* oq = out + i * GN + q * N;
+            size_t j = 0;
+            for (; j + kLanes <= N; j += kLanes) {
+                T acc[RB][kLanes];
+                for (size_t r = 0; r < RB; ++r) {
+                    for (size_t l = 0; l < kLanes; ++l) acc[r][l] = oq[r * GN + j + l];
+                }
+                for (size_t k = 0; k < K; ++k) {
+                    const T* w = wq + k * GN + j;
+                    for (size_t r = 0; r < RB; ++r) {
+                        T xv = xq[r * GK + k];
+                        for (size_t l = 0; l < kLanes; ++l) acc[r][l] += xv * w[l];
+                    }
+                }
+                for (size_t r = 0; r < RB; ++r) {
+                    for (size_t l = 0; l < kLanes; ++l) oq[r * GN + j + l] = acc[r][l];
+                }
+            }
+            for (; j < N; ++j) {
+                T acc[RB];
+                for (size_t r = 0; r < RB; ++r) acc[r] = oq[r * GN + j];
+                for (size_t k = 0; k < K; ++k) {
+                    T wv = wq[k * GN + j];
+                    for (size_t r = 0; r < RB; ++r) acc[r] += xq[r * GK + k] * wv;
+                }
+                for (size_t r = 0; r < RB; ++r) oq[r * GN + j] = acc[r];
+            }
+        }
+    }
+}
+
+template <typename T>
+void grouped_matmul_bias(const T* x, const T* W, const T* b, T* out,
+                         size_t M, size_t K, size_t N, size_t G, const MatmulConfig& cfg) {
+    parallel_ranges(M, cfg.threads, [&](size_t r0, size_t r1) {
+        for (size_t i = r0; i < r1; ++i) {
+            std::copy(b, b + G * N, out + i * G * N);
+        }
+        size_t full = r0 + (r1 - r0) / cfg.row_block * cfg.row_block;
+        switch (cfg.row_block) {
+            case 4: grouped_matmul_rows<T, 4>(x, W, out, r0, full, K, N, G); break;
+            case 2: grouped_matmul_rows<T, 2>(x, W, out, r0, full, K, N, G); break;
+            default: full = r0; break;
+        }
+        grouped_matmul_rows<T, 1>(x, W, out, full, r1, K, N, G);
+    });
+}
+
+//dW = x^T * g por grupo: RB filas de dW comparten cada tramo de g leido
+template <typename T, size_t RB>
+void grouped_grad_weights_rows(const T* x, const T* g, T* dW, size_t k0, size_t k1,
+                               size_t M, size_t K, size_t N, size_t G) {
+    size_t GK = G * K, GN = G * N;
+    for (size_t k = k0; k < k1; k += RB) {
+        for (size_t q = 0; q < G; ++q) {
+            const T* xq = x + q * K + k;
+            const T* gq = g + q * N;
+            T* dq = dW + k * GN + q * N;
+            size_t j = 0;
+            for (; j + kLanes <= N; j += kLanes) {
+                T acc[RB][kLanes] = {};
+                for (size_t i = 0; i < M; ++i) {
+                    const T* gv = gq + i * GN + j;
+                    for (size_t r = 0; r < RB; ++r) {
+                        T xv = xq[i * GK + r];
+                        for (size_t l = 0; l < kLanes; ++l) acc[r][l] += xv * gv[l];
+                    }
+                }
+                for (size_t r = 0; r < RB; ++r) {
+                    for (size_t l = 0; l < kLanes; ++l) dq[r * GN + j + l] = acc[r][l];
+                }
+            }
+            for (; j < N; ++j) {
+                T acc[RB] = {};
+                for (size_t i = 0; i < M; ++i) {
+                    T gv = gq[i * GN + j];
+                    for (size_t r = 0; r < RB; ++r) acc[r] += xq[i * GK + r] * gv;
+                }
+                for (size_t r = 0; r < RB; ++r) dq[r * GN + j] = acc[r];
+            }
+        }
+    }
+}
+
+template <typename T>
+void grouped_matmul_grad_weights(const T* x, const T* g, T* dW,
+                                 size_t M, size_t K, size_t N, size_t G, const MatmulConfig& cfg) {
+    parallel_ranges(K, cfg.threads, [&](size_t k0, size_t k1) {
+        size_t full = k0 + (k1 - k0) / cfg.row_block * cfg.row_block;
+        switch (cfg.row_block) {
+            case 4: grouped_grad_weights_rows<T, 4>(x, g, dW, k0, full, M, K, N, G); break;
+            case 2: grouped_grad_weights_rows<T, 2>(x, g, dW, k0, full, M, K, N, G); break;
+            default: full = k0; break;
+        }
+        grouped_grad_weights_rows<T, 1>(x, g, dW, full, k1, M, K, N, G);
+    });
+}
+
+//dx = g * W^T por grupo: RB filas de g por RB filas de W en acumuladores
+//independientes; cada producto punto conserva el orden de j
+template <typename T, size_t RB>
+void grouped_grad_input_rows(const T* g, const T* W, T* dx, size_t r0, size_t r1,
+                             size_t K, size_t N, size_t G) {
+    size_t GK = G * K, GN = G * N;
+    for (size_t i = r0; i < r1; i += RB) {
+        for (size_t q = 0; q < G; ++q) {
+            const T* gq = g + i * GN + q * N;
+            const T* wq = W + q * N;
+            T* dq = dx + i * GK + q * K;
+            size_t k = 0;
+            for (; k + RB <= K; k += RB) {
+                T acc[RB][RB] = {};
+                for (size_t j = 0; j < N; ++j) {
+                    for (size_t r = 0; r < RB; ++r) {
+                        T gv = gq[r * GN + j];
+                        for (size_t c = 0; c < RB; ++c) acc[r][c] += gv * wq[(k + c) * GN + j];
+                    }
+                }
+                for (size_t r = 0; r < RB; ++r) {
+                    for (size_t c = 0; c < RB; ++c) dq[r * GK + k + c] = acc[r][c];
+                }
+            }
+            for (; k < K; ++k) {
+                T acc[RB] = {};
+                for (size_t j = 0; j < N; ++j) {
+                    T wv = wq[k * GN + j];
+                    for (size_t r = 0; r < RB; ++r) acc[r] += gq[r * GN + j] * wv;
+                }
+                for (size_t r = 0; r < RB; ++r) dq[r * GK + k] = acc[r];
+            }
+        }
+    }
+}
+
+template <typename T>
+void grouped_matmul_grad_input(const T* g, const T* W, T* dx,
+                               size_t M, size_t K, size_t N, size_t G, const MatmulConfig& cfg) {
+    parallel_ranges(M, cfg.threads, [&](size_t r0, size_t r1) {
+        size_t full = r0 + (r1 - r0) / cfg.row_block * cfg.row_block;
+        switch (cfg.row_block) {
+            case 4: grouped_grad_input_rows<T, 4>(g, W, dx, r0, full, K, N, G); break;
+            case 2: grouped_grad_input_rows<T, 2>(g, W, dx, r0, full, K, N, G); break;
+            default: full = r0; break;
+        }
+        grouped_grad_input_rows<T, 1>(g, W, dx, full, r1, K, N, G);
+    });
+}
+
+template <typename T>
+void relu_forward(const T* x, T* y, T* mask, size_t n, const ElementwiseConfig& cfg) {
+    parallel_ranges(n, cfg.threads, [&](size_t i0, size_t i1) {
+        for (size_t i = i0; i < i1; ++i) {
+            mask[i] = x[i] > 0 ? 1 : 0;
+            y[i] = x[i] * mask[i];
+        }
+    });
+}
+
+template <typename T>
+void relu_backward(const T* grad, const T* mask, T* out, size_t n, const ElementwiseConfig& cfg) {
+    parallel_ranges(n, cfg.threads, [&](size_t i0, size_t i1) {
+        for (size_t i = i0; i < i1; ++i) {
+            out[i] = grad[i] * mask[i];
+        }
+    });
+}
+
+} // namespace utec::neural_network
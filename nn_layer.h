@@ -9,5 +9,9 @@ public:
     virtual ~ILayer() = default;
     virtual Tensor<T,2> forward(const Tensor<T,2>& x) = 0;
     virtual Tensor<T,2> backward(const Tensor<T,2>& grad) = 0;
+
+    //Activaciones guardadas en forward para usarlas en backward
+    virtual size_t cache_bytes() const { return 0; }
+    virtual void release_cache() {}
 };
 }
\ No newline at end of file
@@ -0,0 +1,309 @@
+#pragma once
+#include "tensor.h"
+#include "neural_network.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace utec::neural_network {
+
+//Eje discreto de entrada: valores min, min + step, ..., min + (count - 1) * step
+template <typename T>
+struct DiscreteAxis {
+    T min;
+    T step;
+    size_t count;
+};
+
+//Tabla precalculada con la salida de la red para cada punto de un dominio
+//discreto (producto cartesiano de los ejes, el ultimo eje varia mas rapido).
+//Las entradas fuera del dominio se evaluan con la red de respaldo.
+//El archivo guardado con save() se puede mapear en memoria con map().
+template <typename T>
+class LookupTable {
+    static constexpr char kMagic[8] = {'N', 'N', 'L', 'U', 'T', '1', 0, 0};
+    static constexpr size_t kHeaderAlign = 64;
+
+    std::vector<DiscreteAxis<T>> axes;
+    size_t out_dim = 0;
+    std::vector<T> owned;
+    const T* values = nullptr;
+    void* mapping = nullptr;
+    size_t mapping_bytes = 0;
+    NeuralNetwork<T>* fallback = nullptr;
+    T tolerance = 1e-3;
+
+    static size_t header_bytes(size_t rank) {
+        size_t raw = sizeof(kMagic) + 2 * sizeof(uint32_t) + sizeof(uint64_t) +
+                     rank * (2 * sizeof(T) + sizeof(uint64_t));
+        return (raw + kHeaderAlign - 1) / kHeaderAlign * kHeaderAlign;
+    }
+
+    //step > 0 (tambien descarta NaN) y al menos un valor por eje
+    static bool valid_axis(const DiscreteAxis<T>& axis) {
+        return axis.step > 0 && axis.count > 0;
+    }
+
+    void release() {
+        if (mapping) munmap(mapping, mapping_bytes);
+        mapping = nullptr;
+        mapping_bytes = 0;
+    }
+
+public:
+    LookupTable() = default;
+    ~LookupTable() { release(); }
+
+    LookupTable(const LookupTable&) = delete;
+    LookupTable& operator=(const LookupTable&) = delete;
+
+    LookupTable(LookupTable&& other) noexcept { *this = std::move(other); }
+
+    LookupTable& operator=(LookupTable&& other) noexcept {
+        if (this != &other) {
+            release();
+            axes = std::move(other.axes);
+            out_dim = other.out_dim;
+            bool was_owned = other.values == other.owned.data();
+            owned = std::move(other.owned);
+            values = was_owned ? owned.data() : other.values;
+            mapping = std::exchange(other.mapping, nullptr);
+            mapping_bytes = std::exchange(other.mapping_bytes, 0);
+            fallback = other.fallback;
+            tolerance = other.tolerance;
+            other.values = nullptr;
+        }
+        return *this;
+    }
+
+    //Evalua todo el dominio con forwards por lotes de hasta `chunk` puntos
+    static LookupTable compile(NeuralNetwork<T>& nn, std::vector<DiscreteAxis<T>> domain,
+                               size_t chunk = 1 << 16) {
+        if (domain.empty()) {
+            throw std::invalid_argument("Lookup table domain needs at least one axis");
+        }
+        for (const auto& axis : domain) {
+            if (!valid_axis(axis)) {
+                throw std::invalid_argument("Lookup table axes need step > 0 and count > 0");
+            }
+        }
+        LookupTable table;
+        table.axes = std::move(domain);
+        table.fallback = &nn;
+        size_t rank = table.axes.size();
+        //Igual que en map: el producto de los conteos no debe desbordar
+        size_t capacity = std::numeric_limits<size_t>::max() / sizeof(T);
+        size_t total = 1;
+        for (const auto& axis : table.axes) {
+            if (axis.count > capacity / total) {
+                throw std::invalid_argument("Lookup table domain is too large");
+            }
+            total *= axis.count;
+        }
+
+        std::vector<size_t> idx(rank, 0);
+        for (size_t start = 0; start < total; start += chunk) {
+            size_t rows = std::min(chunk, total - start);
+            Tensor<T,2> batch(rows, rank);
+            for (size_t r = 0; r < rows; ++r) {
+                for (size_t a = 0; a < rank; ++a) {
+                    batch.at(r, a) = table.axes[a].min + static_cast<T>(idx[a]) * table.axes[a].step;
+                }
+                for (size_t a = rank; a-- > 0;) {
+                    if (++idx[a] < table.axes[a].count) break;
+                    idx[a] = 0;
+                }
+            }
+            Tensor<T,2> output = nn.forward(batch);
+            if (table.owned.empty()) {
+                table.out_dim = output.shape()[1];
+                if (table.out_dim > capacity / total) {
+                    throw std::invalid_argument("Lookup table domain is too large");
+                }
+                table.owned.resize(total * table.out_dim);
+            }
+            std::copy(output.data(), output.data() + output.size(),
+                      table.owned.begin() + start * table.out_dim);
+        }
+        table.values = table.owned.data();
+        return table;
+    }
+
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        uint32_t type_size = sizeof(T);
+        uint32_t rank = static_cast<uint32_t>(axes.size());
+        uint64_t dim = out_dim;
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char*>(&type_size), sizeof(type_size));
+        out.write(reinterpret_cast<const char*>(&rank), sizeof(rank));
+        out.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+        for (const auto& axis : axes) {
+            uint64_t count = axis.count;
+            out.write(reinterpret_cast<const char*>(&axis.min), sizeof(T));
+            out.write(reinterpret_cast<const char*>(&axis.step), sizeof(T));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        }
+        //Los valores empiezan alineados para poder usarlos directo desde mmap
+        std::vector<char> padding(header_bytes(rank) - static_cast<size_t>(out.tellp()), 0);
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out.write(reinterpret_cast<const char*>(values),
+                  static_cast<std::streamsize>(entries() * out_dim * sizeof(T)));
+        if (!out) {
+            throw std::runtime_error("Could not write " + path);
+        }
+    }
+
+    //Mapea un archivo creado con save(); los valores no se copian a memoria
+    static LookupTable map(const std::string& path, NeuralNetwork<T>* fallback = nullptr) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("Could not stat " + path);
+        }
+        size_t bytes = static_cast<size_t>(st.st_size);
+        void* addr = bytes ? mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("Could not map " + path);
+        }
+
+        LookupTable table;
+        table.mapping = addr;
+        table.mapping_bytes = bytes;
+        table.fallback = fallback;
+
+        const char* p = static_cast<const char*>(addr);
+        auto read = [&](void* dst, size_t n) {
+            if (static_cast<size_t>(p - static_cast<const char*>(addr)) + n > bytes) {
+                throw std::runtime_error("Truncated lookup table " + path);
+            }
+            std::memcpy(dst, p, n);
+            p += n;
+        };
+        char magic[sizeof(kMagic)];
+        uint32_t type_size = 0, rank = 0;
+        uint64_t dim = 0;
+        read(magic, sizeof(magic));
+        read(&type_size, sizeof(type_size));
+        read(&rank, sizeof(rank));
+        read(&dim, sizeof(dim));
+        if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || type_size != sizeof(T) || dim == 0) {
+            throw std::runtime_error("Not a compatible lookup table: " + path);
+        }
+        for (uint32_t a = 0; a < rank; ++a) {
+            DiscreteAxis<T> axis{};
+            uint64_t count = 0;
+            read(&axis.min, sizeof(T));
+            read(&axis.step, sizeof(T));
+            read(&count, sizeof(count));
+            axis.count = count;
+            if (!valid_axis(axis)) {
+                throw std::runtime_error("Corrupt axis in lookup table " + path);
+            }
+            table.axes.push_back(axis);
+        }
+        table.out_dim = dim;
+        //Conteos corruptos no deben desbordar el calculo del tamano
+        size_t capacity = bytes / sizeof(T);
+        size_t needed = dim;
+        for (const auto& axis : table.axes) {
+            if (needed > capacity || axis.count > capacity / std::max<size_t>(needed, 1)) {
+                throw std::runtime_error("Truncated lookup table " + path);
+            }
+            needed *= axis.count;
+        }
+        if (header_bytes(rank) + needed * sizeof(T) > bytes) {
+            throw std::runtime_error("Truncated lookup table " + path);
+        }
+        table.values = reinterpret_cast<const T*>(static_cast<const char*>(addr) + header_bytes(rank));
+        return table;
+    }
+
+    void set_fallback(NeuralNetwork<T>* nn) { fallback = nn; }
+
+    //Distancia maxima al punto de la grilla, como fraccion de step.
+    //Con 0.5 cualquier valor del rango se redondea a la grilla (dominio cuantizado).
+    void set_tolerance(T fraction_of_step) { tolerance = fraction_of_step; }
+
+    size_t entries() const {
+        size_t total = 1;
+        for (const auto& axis : axes) total *= axis.count;
+        return total;
+    }
+
+    size_t output_size() const { return out_dim; }
+
+    size_t memory_bytes() const { return entries() * out_dim * sizeof(T); }
+
+    //Puntero a las salidas precalculadas del punto, o nullptr si esta fuera del dominio
+    const T* find(const T* point) const {
+        size_t index = 0;
+        for (size_t a = 0; a < axes.size(); ++a) {
+            T pos = (point[a] - axes[a].min) / axes[a].step;
+            T nearest = std::round(pos);
+            //Escrito en negativo para que NaN e infinitos queden fuera
+            if (!(nearest >= 0 && nearest < static_cast<T>(axes[a].count) &&
+                  std::abs(pos - nearest) <= tolerance)) {
+                return nullptr;
+            }
+            index = index * axes[a].count + static_cast<size_t>(nearest);
+        }
+        return values + index * out_dim;
+    }
+
+    Tensor<T,2> predict(const Tensor<T,2>& x) {
+        if (x.shape()[1] != axes.size()) {
+            throw std::invalid_argument("Input width doesn't match the lookup table domain");
+        }
+        size_t rows = x.shape()[0];
+        Tensor<T,2> output(rows, out_dim);
+        std::vector<size_t> misses;
+        for (size_t r = 0; r < rows; ++r) {
+            const T* hit = find(x.data() + r * axes.size());
+            if (hit) {
+                std::copy(hit, hit + out_dim, output.data() + r * out_dim);
+            } else {
+                misses.push_back(r);
+            }
+        }
+
+        if (!misses.empty()) {
+            if (!fallback) {
+                throw std::out_of_range("Input outside the lookup table domain and no fallback network");
+            }
+            Tensor<T,2> batch(misses.size(), axes.size());
+            for (size_t m = 0; m < misses.size(); ++m) {
+                std::copy(x.data() + misses[m] * axes.size(), x.data() + (misses[m] + 1) * axes.size(),
+                          batch.data() + m * axes.size());
+            }
+            Tensor<T,2> computed = fallback->forward(batch);
+            for (size_t m = 0; m < misses.size(); ++m) {
+                std::copy(computed.data() + m * out_dim, computed.data() + (m + 1) * out_dim,
+                          output.data() + misses[m] * out_dim);
+            }
+        }
+        return output;
+    }
+};
+
+} // namespace utec::neural_network
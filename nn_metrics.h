@@ -0,0 +1,175 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace utec::neural_network {
+
+struct MetricRecord {
+    size_t epoch = 0, epochs = 0;
+    size_t batch = 0, batches = 0;
+    double loss = 0;
+    double grad_norm = 0;
+    double step_ms = 0;
+    double samples_per_sec = 0;
+    bool epoch_end = false;   //cierre de epoca: loss es la media de la epoca
+};
+
+//Cola circular sin locks para un solo productor y un solo consumidor.
+//head lo escribe solo el consumidor y tail solo el productor.
+template <typename Item, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    std::array<Item, Capacity> items;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+public:
+    bool try_push(const Item& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(Item& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+enum class MetricsFormat { CSV, JSON };
+
+//Destino de metricas de entrenamiento. push() nunca bloquea al hilo de
+//entrenamiento: si la cola esta llena el registro se descarta y se cuenta.
+//Un hilo de fondo escribe cada registro (CSV o JSON lines) y llama al
+//callback. El cierre de epoca llega por end_epoch(), que no se descarta, y
+//el hilo de fondo imprime la perdida media que le pasa el entrenamiento.
+class MetricsSink {
+public:
+    using Callback = std::function<void(const MetricRecord&)>;
+
+    MetricsSink() : worker([this] { run(); }) {}
+
+    ~MetricsSink() {
+        stopping.store(true, std::memory_order_release);
+        worker.join();
+    }
+
+    MetricsSink(const MetricsSink&) = delete;
+    MetricsSink& operator=(const MetricsSink&) = delete;
+
+    //Configurar desde el hilo que entrena, antes del primer push
+    void set_output(std::ostream& out, MetricsFormat fmt = MetricsFormat::CSV) {
+        output = &out;
+        format = fmt;
+        header_written = false;
+    }
+
+    void set_callback(Callback cb) { callback = std::move(cb); }
+
+    //nullptr desactiva el resumen por epoca
+    void set_epoch_summary(std::ostream* out) { summary = out; }
+
+    void push(const MetricRecord& record) {
+        if (ring.try_push(record)) {
+            pushed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    //Una vez por epoca: si la cola esta llena espera a que haya lugar
+    void end_epoch(size_t epoch, size_t epochs, double mean_loss) {
+        MetricRecord record;
+        record.epoch = epoch;
+        record.epochs = epochs;
+        record.loss = mean_loss;
+        record.epoch_end = true;
+        while (!ring.try_push(record)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        pushed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //Espera a que el hilo de fondo procese todo lo encolado
+    void flush() {
+        size_t target = pushed.load(std::memory_order_relaxed);
+        while (consumed.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        if (output) output->flush();
+        if (summary) summary->flush();
+    }
+
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kCapacity = 4096;
+
+    SpscRing<MetricRecord, kCapacity> ring;
+    std::atomic<size_t> pushed{0}, consumed{0}, dropped_{0};
+    std::atomic<bool> stopping{false};
+
+    std::ostream* output = nullptr;
+    std::ostream* summary = &std::cout;
+    MetricsFormat format = MetricsFormat::CSV;
+    bool header_written = false;
+    Callback callback;
+
+    std::thread worker;
+
+    void write(const MetricRecord& r) {
+        if (format == MetricsFormat::CSV) {
+            if (!header_written) {
+                *output << "epoch,batch,loss,grad_norm,step_ms,samples_per_sec\n";
+                header_written = true;
+            }
+            *output << r.epoch + 1 << ',' << r.batch + 1 << ',' << r.loss << ',' << r.grad_norm << ','
+                    << r.step_ms << ',' << r.samples_per_sec << '\n';
+        } else {
+            *output << "{\"epoch\":" << r.epoch + 1 << ",\"batch\":" << r.batch + 1
+                    << ",\"loss\":" << r.loss << ",\"grad_norm\":" << r.grad_norm
+                    << ",\"step_ms\":" << r.step_ms << ",\"samples_per_sec\":" << r.samples_per_sec << "}\n";
+        }
+    }
+
+    void consume(const MetricRecord& r) {
+        if (r.epoch_end) {
+            if (summary) {
+                *summary << "Epoch " << r.epoch + 1 << "/" << r.epochs
+                         << ", Loss: " << r.loss << "\n";
+            }
+            return;
+        }
+        if (output) write(r);
+        if (callback) callback(r);
+    }
+
+    void run() {
+        MetricRecord record;
+        while (true) {
+            bool stop = stopping.load(std::memory_order_acquire);
+            bool any = false;
+            while (ring.try_pop(record)) {
+                consume(record);
+                consumed.fetch_add(1, std::memory_order_release);
+                any = true;
+            }
+            if (stop) break;
+            if (!any) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (output) output->flush();
+        if (summary) summary->flush();
+    }
+};
+
+} // namespace utec::neural_network
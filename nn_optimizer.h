@@ -13,6 +13,17 @@ public:
     virtual void update(Tensor<T,1>& param, const Tensor<T,1>& grad) = 0;
 };
 
+//Combina los gradientes de varias replicas antes de optimize().
+//on_gradient_ready se llama en cuanto backward termina cada capa Dense, para
+//poder solapar la comunicacion con el resto del backward.
+template<typename T>
+class IGradientReducer {
+public:
+    virtual ~IGradientReducer() = default;
+    virtual void on_gradient_ready(Tensor<T,2>& dW, Tensor<T,1>& db) = 0;
+    virtual void synchronize() = 0;
+};
+
 template<typename T>
 class SGD : public IOptimizer<T> {
     T learning_rate;
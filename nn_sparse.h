@@ -0,0 +1,143 @@
+#pragma once
+#include "tensor.h"
+#include "nn_layer.h"
+#include "nn_dense.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace utec::neural_network {
+
+//Poda por magnitud: pone en cero la fraccion `sparsity` de pesos con menor |w|.
+//Devuelve la cantidad de pesos que quedan en cero.
+template <typename T>
+size_t prune_magnitude(Tensor<T,2>& W, double sparsity) {
+    if (sparsity < 0.0 || sparsity > 1.0) {
+        throw std::invalid_argument("Sparsity must be in [0, 1]");
+    }
+    size_t n = W.size();
+    size_t k = static_cast<size_t>(sparsity * static_cast<double>(n));
+    if (k == 0) return 0;
+
+    T* w = W.data();
+    std::vector<std::pair<T, size_t>> magnitudes(n);
+    for (size_t i = 0; i < n; ++i) {
+        magnitudes[i] = {std::abs(w[i]), i};
+    }
+    std::nth_element(magnitudes.begin(), magnitudes.begin() + (k - 1), magnitudes.end());
+    for (size_t i = 0; i < k; ++i) {
+        w[magnitudes[i].second] = 0;
+    }
+    return k;
+}
+
+//Programa de poda gradual (cubico): la sparsity sube rapido al inicio y se
+//estabiliza al acercarse a `end_epoch`.
+inline double pruning_target(double final_sparsity, size_t epoch, size_t start_epoch, size_t end_epoch) {
+    if (epoch < start_epoch) return 0.0;
+    if (epoch >= end_epoch) return final_sparsity;
+    double progress = static_cast<double>(epoch - start_epoch + 1) /
+                      static_cast<double>(end_epoch - start_epoch + 1);
+    return final_sparsity * (1.0 - std::pow(1.0 - progress, 3));
+}
+
+//Capa densa de inferencia con W almacenada en formato CSR.
+//Las filas del CSR son las entradas (k) y las columnas las salidas (j), igual que W.
+template <typename T>
+class SparseDense : public ILayer<T> {
+public:
+    std::vector<uint32_t> row_ptr;
+    std::vector<uint32_t> col_idx;
+    std::vector<T> values;
+    Tensor<T,1> b;
+    size_t in_feats, out_feats;
+
+    explicit SparseDense(const Dense<T>& dense)
+        : b(dense.b), in_feats(dense.W.shape()[0]), out_feats(dense.W.shape()[1]) {
+        const T* w = dense.W.data();
+        row_ptr.reserve(in_feats + 1);
+        row_ptr.push_back(0);
+        for (size_t k = 0; k < in_feats; ++k) {
+            for (size_t j = 0; j < out_feats; ++j) {
+                T value = w[k * out_feats + j];
+                if (value != 0) {
+                    col_idx.push_back(static_cast<uint32_t>(j));
+                    values.push_back(value);
+                }
+            }
+            row_ptr.push_back(static_cast<uint32_t>(values.size()));
+        }
+    }
+
+    //Producto disperso: out = x * W + b, recorriendo solo los pesos no nulos
+    Tensor<T,2> forward(const Tensor<T,2>& x) override {
+        if (x.shape()[1] != in_feats) {
+            throw std::invalid_argument("Input width doesn't match the sparse layer");
+        }
+        size_t batch = x.shape()[0];
+        Tensor<T,2> output(batch, out_feats);
+        const T* in = x.data();
+        T* out = output.data();
+
+        for (size_t i = 0; i < batch; ++i) {
+            T* out_row = out + i * out_feats;
+            for (size_t j = 0; j < out_feats; ++j) {
+                out_row[j] = b.at(j);
+            }
+            const T* x_row = in + i * in_feats;
+            for (size_t k = 0; k < in_feats; ++k) {
+                T xv = x_row[k];
+                if (xv == 0) continue;
+                for (uint32_t p = row_ptr[k]; p < row_ptr[k + 1]; ++p) {
+                    out_row[col_idx[p]] += xv * values[p];
+                }
+            }
+        }
+        return output;
+    }
+
+    //Capa solo de inferencia: propaga el gradiente de entrada, los pesos no se entrenan
+    Tensor<T,2> backward(const Tensor<T,2>& grad) override {
+        if (grad.shape()[1] != out_feats) {
+            throw std::invalid_argument("Gradient width doesn't match the sparse layer");
+        }
+        size_t batch = grad.shape()[0];
+        Tensor<T,2> input_grad(batch, in_feats);
+        const T* g = grad.data();
+        T* out = input_grad.data();
+
+        for (size_t i = 0; i < batch; ++i) {
+            const T* g_row = g + i * out_feats;
+            for (size_t k = 0; k < in_feats; ++k) {
+                T acc = 0;
+                for (uint32_t p = row_ptr[k]; p < row_ptr[k + 1]; ++p) {
+                    acc += values[p] * g_row[col_idx[p]];
+                }
+                out[i * in_feats + k] = acc;
+            }
+        }
+        return input_grad;
+    }
+
+    size_t nnz() const { return values.size(); }
+
+    double sparsity() const {
+        return 1.0 - static_cast<double>(nnz()) / static_cast<double>(in_feats * out_feats);
+    }
+
+    //Bytes ocupados por W en CSR (sin contar el bias, igual en ambas versiones)
+    size_t memory_bytes() const {
+        return row_ptr.size() * sizeof(uint32_t) +
+               col_idx.size() * sizeof(uint32_t) +
+               values.size() * sizeof(T);
+    }
+
+    size_t dense_memory_bytes() const {
+        return in_feats * out_feats * sizeof(T);
+    }
+};
+
+} // namespace utec::neural_network
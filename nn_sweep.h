@@ -0,0 +1,290 @@
+#pragma once
+#include "tensor.h"
+#include "neural_network.h"
+#include "nn_dense.h"
+#include "nn_activation.h"
+#include "nn_kernels.h"
+#include "nn_autotune.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace utec::neural_network {
+
+enum class SweepOptimizer { SGD, Adam };
+
+template <typename T>
+struct SweepConfig {
+    unsigned seed = 0;
+    T learning_rate = 0.001;
+    SweepOptimizer optimizer = SweepOptimizer::Adam;
+    T beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+};
+
+template <typename T>
+struct SweepResult {
+    //loss_curves[m][epoch]: perdida media por epoca del modelo m
+    std::vector<std::vector<T>> loss_curves;
+    double wall_ms = 0;
+};
+
+//Entrena a la vez muchos MLP con la misma forma (Dense + ReLU, salida lineal)
+//y distinta semilla / optimizador. Los pesos de la capa l de todos los
+//modelos se apilan por columnas en una matriz sizes[l] x (models * sizes[l+1])
+//y las activaciones en lote x (models * ancho). La capa 0 es un solo producto
+//del lote compartido por la matriz apilada (el lote se lee una vez); las
+//demas recorren cada fila de pesos una vez para todos los modelos.
+template <typename T>
+class ModelSweep {
+    std::vector<size_t> sizes;
+    std::vector<SweepConfig<T>> configs;
+    size_t models;
+
+    //Por capa l: W[l] con forma (in, models * out) y b[l] con forma (1, models * out);
+    //el modelo m ocupa las columnas [m * out, (m + 1) * out)
+    std::vector<Tensor<T,2>> W, b, dW, db;
+    std::vector<Tensor<T,2>> mW, vW, mb, vb;
+    //Igual que Adam: el contador avanza en cada update, no en cada paso
+    std::vector<size_t> steps;
+
+    //acts[l] y grads[l]: (lote, models * sizes[l]); masks[l]: mascara de la
+    //ReLU que sigue a la capa l - 1
+    struct Workspace {
+        std::vector<std::vector<T>> acts, grads, masks;
+    };
+
+    size_t layer_count() const { return sizes.size() - 1; }
+
+    //Actualiza las columnas del modelo en cada fila del parametro apilado
+    void update(Tensor<T,2>& param, const Tensor<T,2>& grad, Tensor<T,2>& m, Tensor<T,2>& v,
+                size_t width, size_t model) {
+        const auto& cfg = configs[model];
+        size_t rows = param.shape()[0], stride = models * width;
+        if (cfg.optimizer == SweepOptimizer::SGD) {
+            for (size_t r = 0; r < rows; ++r) {
+                T* p = param.data() + r * stride + model * width;
+                const T* g = grad.data() + r * stride + model * width;
+                for (size_t i = 0; i < width; ++i) {
+                    p[i] -= cfg.learning_rate * g[i];
+                }
+            }
+            return;
+        }
+        size_t t = ++steps[model];
+        T beta1_t = std::pow(cfg.beta1, t);
+        T beta2_t = std::pow(cfg.beta2, t);
+        for (size_t r = 0; r < rows; ++r) {
+            size_t offset = r * stride + model * width;
+            T* p = param.data() + offset;
+            const T* g = grad.data() + offset;
+            T* mm = m.data() + offset;
+            T* vv = v.data() + offset;
+            for (size_t i = 0; i < width; ++i) {
+                mm[i] = cfg.beta1 * mm[i] + (1 - cfg.beta1) * g[i];
+                vv[i] = cfg.beta2 * vv[i] + (1 - cfg.beta2) * g[i] * g[i];
+                T m_hat = mm[i] / (1 - beta1_t);
+                T v_hat = vv[i] / (1 - beta2_t);
+                p[i] -= cfg.learning_rate * m_hat / (std::sqrt(v_hat) + cfg.epsilon);
+            }
+        }
+    }
+
+    //Un paso (forward, backward, update) de todos los modelos sobre un lote
+    void step(const T* x, const T* y, size_t batch, size_t threads, Workspace& ws, std::vector<T>& losses) {
+        size_t L = layer_count();
+        auto& tuner = Autotuner::instance();
+        MatmulConfig grouped;
+        grouped.row_block = 4;
+        grouped.threads = threads;
+
+        //Forward
+        for (size_t l = 0; l < L; ++l) {
+            size_t in = sizes[l], out = sizes[l + 1];
+            T* dst = ws.acts[l + 1].data();
+            if (l == 0) {
+                auto cfg = tuner.matmul<T>(batch, in, models * out);
+                cfg.threads = std::min(cfg.threads, threads);
+                matmul_bias(x, W[0].data(), b[0].data(), dst, batch, in, models * out, cfg);
+            } else {
+                grouped_matmul_bias(ws.acts[l].data(), W[l].data(), b[l].data(), dst,
+                                    batch, in, out, models, grouped);
+            }
+            if (l + 1 < L) {
+                size_t n = batch * models * out;
+                auto cfg = tuner.elementwise<T>(n);
+                cfg.threads = std::min(cfg.threads, threads);
+                relu_forward(dst, dst, ws.masks[l + 1].data(), n, cfg);
+            }
+        }
+
+        //MSE por modelo y su gradiente
+        size_t out_dim = sizes.back();
+        size_t stride = models * out_dim;
+        T factor = 2.0 / (batch * out_dim);
+        const T* pred = ws.acts[L].data();
+        T* g_last = ws.grads[L].data();
+        for (size_t m = 0; m < models; ++m) {
+            T loss = 0;
+            for (size_t i = 0; i < batch; ++i) {
+                for (size_t j = 0; j < out_dim; ++j) {
+                    size_t idx = i * stride + m * out_dim + j;
+                    T diff = pred[idx] - y[i * out_dim + j];
+                    loss += diff * diff;
+                    g_last[idx] = factor * diff;
+                }
+            }
+            losses[m] += loss / (batch * out_dim);
+        }
+
+        //Backward
+        for (size_t l = L; l-- > 0;) {
+            size_t in = sizes[l], out = sizes[l + 1];
+            const T* g = ws.grads[l + 1].data();
+            if (l == 0) {
+                auto cfg = tuner.matmul<T>(batch, in, models * out, MatmulOp::GradWeights);
+                cfg.threads = std::min(cfg.threads, threads);
+                matmul_grad_weights(x, g, dW[0].data(), batch, in, models * out, cfg);
+            } else {
+                grouped_matmul_grad_weights(ws.acts[l].data(), g, dW[l].data(),
+                                            batch, in, out, models, grouped);
+            }
+
+            T* dbl = db[l].data();
+            std::fill(dbl, dbl + models * out, T(0));
+            for (size_t i = 0; i < batch; ++i) {
+                const T* g_row = g + i * models * out;
+                for (size_t c = 0; c < models * out; ++c) {
+                    dbl[c] += g_row[c];
+                }
+            }
+
+            if (l > 0) {
+                //Gradiente de entrada por la mascara de la ReLU anterior
+                T* gin = ws.grads[l].data();
+                grouped_matmul_grad_input(g, W[l].data(), gin, batch, in, out, models, grouped);
+                size_t n = batch * models * in;
+                auto cfg = tuner.elementwise<T>(n);
+                cfg.threads = std::min(cfg.threads, threads);
+                relu_backward(gin, ws.masks[l].data(), gin, n, cfg);
+            }
+        }
+
+        //Mismo orden que NeuralNetwork::optimize: por capa, W y luego b
+        parallel_ranges(models, threads, [&](size_t m0, size_t m1) {
+            for (size_t m = m0; m < m1; ++m) {
+                for (size_t l = 0; l < L; ++l) {
+                    update(W[l], dW[l], mW[l], vW[l], sizes[l + 1], m);
+                    update(b[l], db[l], mb[l], vb[l], sizes[l + 1], m);
+                }
+            }
+        });
+    }
+
+public:
+    ModelSweep(std::vector<size_t> layer_sizes, std::vector<SweepConfig<T>> model_configs)
+        : sizes(std::move(layer_sizes)), configs(std::move(model_configs)), models(configs.size()) {
+        if (sizes.size() < 2 || models == 0) {
+            throw std::invalid_argument("ModelSweep needs at least one layer and one model");
+        }
+        steps.assign(models, 0);
+        for (size_t l = 0; l < layer_count(); ++l) {
+            size_t in = sizes[l], out = sizes[l + 1];
+            W.emplace_back(in, models * out);
+            b.emplace_back(1, models * out);
+            dW.emplace_back(in, models * out);
+            db.emplace_back(1, models * out);
+            mW.emplace_back(in, models * out);
+            vW.emplace_back(in, models * out);
+            mb.emplace_back(1, models * out);
+            vb.emplace_back(1, models * out);
+        }
+
+        //Misma inicializacion que Dense, pero con la semilla de cada modelo
+        for (size_t m = 0; m < models; ++m) {
+            std::mt19937 gen(configs[m].seed);
+            for (size_t l = 0; l < layer_count(); ++l) {
+                size_t in = sizes[l], out = sizes[l + 1];
+                T limit = std::sqrt(6.0 / (in + out));
+                std::uniform_real_distribution<T> dis(-limit, limit);
+                for (size_t k = 0; k < in; ++k) {
+                    T* w_row = W[l].data() + k * models * out + m * out;
+                    for (size_t j = 0; j < out; ++j) {
+                        w_row[j] = dis(gen);
+                    }
+                }
+            }
+        }
+    }
+
+    size_t size() const { return models; }
+
+    //Entrena todos los modelos; cada capa se reparte entre `threads` hilos
+    //(0 = hardware_concurrency)
+    SweepResult<T> train(const Tensor<T,2>& X, const Tensor<T,2>& Y, size_t epochs,
+                         size_t batch_size = 32, size_t threads = 0) {
+        if (X.shape()[1] != sizes.front() || Y.shape()[1] != sizes.back()) {
+            throw std::invalid_argument("Data shape doesn't match the sweep layer sizes");
+        }
+        if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+        SweepResult<T> result;
+        result.loss_curves.assign(models, std::vector<T>(epochs, 0));
+        size_t samples = X.shape()[0];
+        size_t num_batches = (samples + batch_size - 1) / batch_size;
+
+        Workspace ws;
+        ws.acts.resize(sizes.size());
+        ws.grads.resize(sizes.size());
+        ws.masks.resize(sizes.size());
+        for (size_t l = 1; l < sizes.size(); ++l) {
+            ws.acts[l].resize(batch_size * models * sizes[l]);
+            ws.grads[l].resize(batch_size * models * sizes[l]);
+            if (l + 1 < sizes.size()) {
+                ws.masks[l].resize(batch_size * models * sizes[l]);
+            }
+        }
+        std::vector<T> losses(models);
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        for (size_t epoch = 0; epoch < epochs; ++epoch) {
+            std::fill(losses.begin(), losses.end(), T(0));
+            for (size_t batch = 0; batch < num_batches; ++batch) {
+                size_t start = batch * batch_size;
+                size_t end = std::min(start + batch_size, samples);
+                step(X.data() + start * sizes.front(), Y.data() + start * sizes.back(),
+                     end - start, threads, ws, losses);
+            }
+            for (size_t m = 0; m < models; ++m) {
+                result.loss_curves[m][epoch] = losses[m] / num_batches;
+            }
+        }
+        result.wall_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start_time).count();
+        return result;
+    }
+
+    //Copia el modelo m a una NeuralNetwork independiente (sin optimizador)
+    NeuralNetwork<T> to_network(size_t m) const {
+        NeuralNetwork<T> nn;
+        for (size_t l = 0; l < layer_count(); ++l) {
+            size_t in = sizes[l], out = sizes[l + 1];
+            auto dense = std::make_unique<Dense<T>>(in, out);
+            for (size_t k = 0; k < in; ++k) {
+                const T* w_row = W[l].data() + k * models * out + m * out;
+                std::copy(w_row, w_row + out, dense->W.data() + k * out);
+            }
+            std::copy(b[l].data() + m * out, b[l].data() + (m + 1) * out, dense->b.data());
+            nn.add_layer(std::move(dense));
+            if (l + 1 < layer_count()) {
+                nn.add_layer(std::make_unique<ReLU<T>>());
+            }
+        }
+        return nn;
+    }
+};
+
+} // namespace utec::neural_network
@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utec::neural_network {
+
+//Pool de hilos con robo de trabajo: cada hilo tiene su propia cola, toma
+//sus tareas del final (LIFO, datos aun en cache) y, cuando se queda sin
+//trabajo, roba del inicio de la cola de otro hilo.
+class WorkStealingPool {
+    struct Queue {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> next_queue{0};
+    bool stopping = false;
+    std::mutex state_mtx;
+    std::condition_variable wake_cv, done_cv;
+    std::exception_ptr error;
+
+    static inline thread_local WorkStealingPool* current_pool = nullptr;
+    static inline thread_local size_t current_index = 0;
+
+    bool try_take(size_t index, std::function<void()>& task) {
+        {
+            auto& own = *queues[index];
+            std::lock_guard<std::mutex> lock(own.mtx);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            auto& victim = *queues[(index + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mtx);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t index) {
+        current_pool = this;
+        current_index = index;
+        std::function<void()> task;
+        while (true) {
+            if (try_take(index, task)) {
+                queued.fetch_sub(1);
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state_mtx);
+                    if (!error) error = std::current_exception();
+                }
+                task = nullptr;
+                if (pending.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(state_mtx);
+                    done_cv.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(state_mtx);
+            wake_cv.wait(lock, [&] { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() == 0) return;
+        }
+    }
+
+public:
+    explicit WorkStealingPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(state_mtx);
+            stopping = true;
+        }
+        wake_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    //Desde un hilo del pool la tarea va a su propia cola; desde fuera se reparte
+    void submit(std::function<void()> task) {
+        size_t index = current_pool == this ? current_index : next_queue.fetch_add(1) % queues.size();
+        pending.fetch_add(1);
+        {
+            auto& queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mtx);
+            queue.tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(state_mtx);
+        }
+        wake_cv.notify_one();
+    }
+
+    //Espera a que terminen todas las tareas (incluidas las que estas crean)
+    //y relanza la primera excepcion que haya ocurrido
+    void wait() {
+        std::unique_lock<std::mutex> lock(state_mtx);
+        done_cv.wait(lock, [&] { return pending.load() == 0; });
+        if (error) {
+            auto e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+};
+
+} // namespace utec::neural_network
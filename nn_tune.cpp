@@ -0,0 +1,81 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "nn_autotune.h"
+
+using namespace utec::neural_network;
+
+//Pre-ajuste offline de los kernels para las formas de un modelo.
+//Uso: nn_tune [--layers 2,64,32,16,1] [--batch 32,8,1] [--cache archivo] [--double]
+
+std::vector<size_t> parseList(const std::string& text) {
+    std::vector<size_t> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(std::stoul(item));
+    }
+    return values;
+}
+
+void printMatmul(const char* label, size_t batch, size_t in, size_t out, const MatmulConfig& mm) {
+    std::cout << label << " " << batch << "x" << in << "x" << out
+              << ": tile_k=" << mm.tile_k << " tile_j=" << mm.tile_j
+              << " row_block=" << mm.row_block << " hilos=" << mm.threads << "\n";
+}
+
+template <typename T>
+void tuneModel(const std::vector<size_t>& layers, const std::vector<size_t>& batches) {
+    auto& tuner = Autotuner::instance();
+    for (size_t batch : batches) {
+        for (size_t l = 0; l + 1 < layers.size(); ++l) {
+            size_t in = layers[l], out = layers[l + 1];
+            printMatmul("matmul   ", batch, in, out, tuner.matmul<T>(batch, in, out));
+            printMatmul("matmul_dw", batch, in, out, tuner.matmul<T>(batch, in, out, MatmulOp::GradWeights));
+            printMatmul("matmul_dx", batch, in, out, tuner.matmul<T>(batch, in, out, MatmulOp::GradInput));
+
+            //ReLU despues de cada capa oculta
+            if (l + 2 < layers.size()) {
+                size_t n = batch * out;
+                auto ew = tuner.elementwise<T>(n);
+                std::cout << "relu      " << n << ": hilos=" << ew.threads << "\n";
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> layers = {2, 64, 32, 16, 1};
+    std::vector<size_t> batches = {32, 8, 1};
+    bool use_double = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--layers" && i + 1 < argc) {
+            layers = parseList(argv[++i]);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batches = parseList(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            Autotuner::instance().set_cache_path(argv[++i]);
+        } else if (arg == "--double") {
+            use_double = true;
+        } else {
+            std::cerr << "Uso: " << argv[0]
+                      << " [--layers 2,64,32,16,1] [--batch 32,8,1] [--cache archivo] [--double]\n";
+            return 1;
+        }
+    }
+    if (layers.size() < 2 || batches.empty()) {
+        std::cerr << "Se necesitan al menos dos tamanos de capa y un tamano de lote\n";
+        return 1;
+    }
+
+    std::cout << "CPU: " << Autotuner::instance().cpu() << "\n";
+    if (use_double) {
+        tuneModel<double>(layers, batches);
+    } else {
+        tuneModel<float>(layers, batches);
+    }
+    return 0;
+}
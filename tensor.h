@@ -99,6 +99,10 @@ public:
     const std::vector<size_t>& shape() const { return shape_; }
     size_t size() const { return data_.size(); }
 
+    //Acceso directo al buffer contiguo (row-major) para los kernels
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
     //Método slice para dividir el tensor
     Tensor slice(size_t start_row, size_t end_row) const {
         static_assert(Rank == 2, "Slice is only implemented for 2D tensors");